@@ -0,0 +1,69 @@
+#!/bin/bash
+#
+# Golden-suite compile times with and without the precompiled stdlib artifact.
+#
+# Runs `check` (parse, resolve, typecheck; no codegen) on every golden test
+# twice: once with BLOOD_NO_STDLIB_ARTIFACT=1, so every stdlib module is
+# parsed from source, and once with the artifact warmed up, so they are
+# decoded from the build cache. Prints per-test wall time for both runs
+# and the totals.
+#
+# Usage: ./benchmarks/golden_compile_times.sh [COMPILER] [FILTER]
+#   COMPILER: blood compiler (default: src/selfhost/build/first_gen)
+#   FILTER:   optional test-name prefix, e.g. "t05"
+
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+REPO_ROOT="$(dirname "$SCRIPT_DIR")"
+BLOOD="${1:-$REPO_ROOT/src/selfhost/build/first_gen}"
+FILTER="${2:-}"
+GOLDEN_DIR="$REPO_ROOT/tests/golden"
+STDLIB="$REPO_ROOT/stdlib"
+
+if [ ! -x "$BLOOD" ]; then
+    echo "Error: compiler not found at $BLOOD"
+    exit 1
+fi
+
+# Keep the artifact out of the user's cache.
+export BLOOD_CACHE
+BLOOD_CACHE=$(mktemp -d)
+trap 'rm -rf "$BLOOD_CACHE"' EXIT
+
+# Wall time of one `check`, in milliseconds.
+time_check() {
+    local src="$1" start end
+    start=$(date +%s%N)
+    "$BLOOD" check "$src" --stdlib-path "$STDLIB" > /dev/null 2>&1 || true
+    end=$(date +%s%N)
+    echo $(( (end - start) / 1000000 ))
+}
+
+# Warm the artifact: the first stdlib user writes it.
+first_std=$(grep -l '^use std\|^mod std' "$GOLDEN_DIR"/t[0-9][0-9]_*.blood | head -1)
+if [ -n "$first_std" ]; then
+    "$BLOOD" check "$first_std" --stdlib-path "$STDLIB" > /dev/null 2>&1 || true
+fi
+
+echo "Compiler: $BLOOD"
+printf "%-48s %10s %10s\n" "test" "parse_ms" "artifact_ms"
+
+total_parse=0
+total_artifact=0
+count=0
+for src in "$GOLDEN_DIR"/t[0-9][0-9]_*.blood; do
+    name=$(basename "$src" .blood)
+    if [ -n "$FILTER" ] && [[ ! "$name" =~ ^$FILTER ]]; then
+        continue
+    fi
+    without=$(BLOOD_NO_STDLIB_ARTIFACT=1 time_check "$src")
+    with=$(time_check "$src")
+    printf "%-48s %10d %10d\n" "$name" "$without" "$with"
+    total_parse=$((total_parse + without))
+    total_artifact=$((total_artifact + with))
+    count=$((count + 1))
+done
+
+echo ""
+printf "%-48s %10d %10d\n" "total ($count tests)" "$total_parse" "$total_artifact"
@@ -1,7 +1,7 @@
 #!/bin/bash
 # Blood Micro-Benchmark Runner
 # Compiles and runs all Blood micro-benchmarks, compares against spec targets.
-# Usage: ./run_micro.sh [--release] [--bench <name>]
+# Usage: ./run_micro.sh [--release] [--compressed-refs] [--bench <name>]
 
 set -euo pipefail
 
@@ -11,10 +11,12 @@ BLOOD="${BLOOD_REF:-$REPO_ROOT/src/bootstrap/target/release/blood}"
 
 MODE="debug"
 FILTER=""
+EXTRA_FLAGS=""
 
 while [[ $# -gt 0 ]]; do
     case "$1" in
         --release) MODE="release"; shift ;;
+        --compressed-refs) EXTRA_FLAGS="--compressed-refs"; shift ;;
         --bench) FILTER="$2"; shift 2 ;;
         *) echo "Unknown option: $1"; exit 1 ;;
     esac
@@ -24,6 +26,7 @@ BUILD_FLAGS=""
 if [[ "$MODE" == "release" ]]; then
     BUILD_FLAGS="--release"
 fi
+BUILD_FLAGS="$BUILD_FLAGS $EXTRA_FLAGS"
 
 # Spec targets (nanoseconds)
 declare -A TARGETS=(
@@ -59,11 +62,15 @@ run_bench() {
         echo "  SKIP: $bin not found"
         return 1
     fi
+    local out="/dev/stdout"
+    if [[ -n "${DISCARD_STDOUT[$name]:-}" ]]; then
+        out="/dev/null"
+    fi
     # CPU pin if taskset is available
     if command -v taskset &>/dev/null; then
-        taskset -c 0 "$bin"
+        taskset -c 0 "$bin" > "$out"
     else
-        "$bin"
+        "$bin" > "$out"
     fi
 }
 
@@ -109,6 +116,7 @@ BENCHMARKS=(
     bench_region_dealloc
     bench_persistent_alloc
     bench_pointer_overhead
+    bench_pointer_chase
     bench_effect_handler_install
     bench_effect_dispatch
     bench_effect_state_loop
@@ -116,6 +124,14 @@ BENCHMARKS=(
     bench_static_dispatch
     bench_trait_dispatch
     bench_enum_dispatch
+    bench_tail_recursion
+    bench_string_grow
+    bench_print_lines
+)
+
+# Benchmarks whose stdout is the workload; their results go to stderr.
+declare -A DISCARD_STDOUT=(
+    [bench_print_lines]=1
 )
 
 for bench in "${BENCHMARKS[@]}"; do
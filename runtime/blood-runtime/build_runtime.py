@@ -42,7 +42,7 @@ def process_ir(input_path, output_path):
         # Stage 2 type conversion builtins
         'i32_to_i64', 'i64_to_i32', 'size_of_bool', 'size_of_i32', 'size_of_i64',
         # Stage 2 number-to-string conversions
-        'i64_to_string', 'u64_to_string', 'f32_to_string', 'f64_to_string',
+        'i64_to_string', 'u64_to_string',
         'i8_to_string', 'i16_to_string', 'i128_to_string',
         'u8_to_string', 'u16_to_string', 'u32_to_string', 'u128_to_string',
         # Stage 2 file I/O
@@ -351,31 +351,8 @@ def process_ir(input_path, output_path):
     impl_lines.append('  ret { ptr, i64 } %r2\n')
     impl_lines.append('}\n')
 
-    # f32_to_string(float) -> { ptr, i64 } — fpext to double, format with %g
-    impl_lines.append('@.fmt_g = private unnamed_addr constant [3 x i8] c"%g\\00"\n')
-    impl_lines.append('define { ptr, i64 } @f32_to_string(float %n) {\n')
-    impl_lines.append('  %d = fpext float %n to double\n')
-    impl_lines.append('  %buf = alloca [32 x i8]\n')
-    impl_lines.append('  %len = call i32 (ptr, i64, ptr, ...) @snprintf(ptr %buf, i64 32, ptr @.fmt_g, double %d)\n')
-    impl_lines.append('  %len64 = sext i32 %len to i64\n')
-    impl_lines.append('  %mem = call ptr @calloc(i64 1, i64 %len64)\n')
-    impl_lines.append('  call void @llvm.memcpy.p0.p0.i64(ptr %mem, ptr %buf, i64 %len64, i1 false)\n')
-    impl_lines.append('  %r1 = insertvalue { ptr, i64 } undef, ptr %mem, 0\n')
-    impl_lines.append('  %r2 = insertvalue { ptr, i64 } %r1, i64 %len64, 1\n')
-    impl_lines.append('  ret { ptr, i64 } %r2\n')
-    impl_lines.append('}\n')
-
-    # f64_to_string(double) -> { ptr, i64 }
-    impl_lines.append('define { ptr, i64 } @f64_to_string(double %n) {\n')
-    impl_lines.append('  %buf = alloca [32 x i8]\n')
-    impl_lines.append('  %len = call i32 (ptr, i64, ptr, ...) @snprintf(ptr %buf, i64 32, ptr @.fmt_g, double %n)\n')
-    impl_lines.append('  %len64 = sext i32 %len to i64\n')
-    impl_lines.append('  %mem = call ptr @calloc(i64 1, i64 %len64)\n')
-    impl_lines.append('  call void @llvm.memcpy.p0.p0.i64(ptr %mem, ptr %buf, i64 %len64, i1 false)\n')
-    impl_lines.append('  %r1 = insertvalue { ptr, i64 } undef, ptr %mem, 0\n')
-    impl_lines.append('  %r2 = insertvalue { ptr, i64 } %r1, i64 %len64, 1\n')
-    impl_lines.append('  ret { ptr, i64 } %r2\n')
-    impl_lines.append('}\n')
+    # f32_to_string and f64_to_string are defined in rt_box.blood (rt_float's
+    # shortest round-trip formatting), not injected here.
 
     # --- Stage 2 file I/O ---
 
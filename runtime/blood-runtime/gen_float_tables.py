@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""Generate rt_float_table.blood: the 128-bit power-of-five tables used by
+rt_float for shortest float formatting (Ryu) and float parsing
+(Eisel-Lemire).
+
+Both tables are emitted as hex strings, 32 digits per entry, high word
+first. rt_float decodes them into memory on first use.
+
+POW5_128 holds 5^q for q in [-342, 325], normalized to 128 bits:
+  q >= 0: 5^q shifted so its top bit is bit 127, truncated.
+  q <  0: 2^b / 5^-q rounded up, for the smallest b that keeps 128 bits
+          (the table from Lemire, "Number Parsing at a Gigabyte per
+          Second", 2021).
+Ryu's DOUBLE_POW5_SPLIT is the q >= 0 half shifted right by 3.
+
+POW5_INV holds Ryu's DOUBLE_POW5_INV_SPLIT for q in [0, 341]:
+  floor(2^(bitlen(5^q) - 1 + 125) / 5^q) + 1.
+
+Usage: ./gen_float_tables.py > rt_float_table.blood
+"""
+
+POW5_MIN_Q = -342
+POW5_MAX_Q = 325
+POW5_INV_COUNT = 342
+POW5_INV_BITCOUNT = 125
+
+
+def pow5_128(q):
+    if q >= 0:
+        v = 5 ** q
+        while v < (1 << 127):
+            v <<= 1
+        while v >= (1 << 128):
+            v >>= 1
+        return v
+    power5 = 5 ** -q
+    z = 0
+    while (1 << z) < power5:
+        z += 1
+    if q >= -27:
+        return (1 << (z + 127)) // power5 + 1
+    v = (1 << (2 * z + 128)) // power5 + 1
+    while v >= (1 << 128):
+        v >>= 1
+    return v
+
+
+def pow5_inv(q):
+    power5 = 5 ** q
+    j = power5.bit_length() - 1 + POW5_INV_BITCOUNT
+    return (1 << j) // power5 + 1
+
+
+def hex_table(values):
+    return ''.join('%032x' % v for v in values)
+
+
+def main():
+    pow5 = hex_table(pow5_128(q) for q in range(POW5_MIN_Q, POW5_MAX_Q + 1))
+    inv = hex_table(pow5_inv(q) for q in range(POW5_INV_COUNT))
+    print('// Generated by gen_float_tables.py. Do not edit.')
+    print('//')
+    print('// 128-bit power-of-five tables for rt_float, 32 hex digits per entry,')
+    print('// high word first.')
+    print()
+    print('/// 5^q normalized to 128 bits, for q in [%d, %d].' % (POW5_MIN_Q, POW5_MAX_Q))
+    print('pub fn pow5_128_hex() -> &str {')
+    print('    "%s"' % pow5)
+    print('}')
+    print()
+    print('/// Ryu inverse multipliers floor(2^(bitlen(5^q) + %d) / 5^q) + 1, for q in [0, %d].'
+          % (POW5_INV_BITCOUNT - 1, POW5_INV_COUNT - 1))
+    print('pub fn pow5_inv_hex() -> &str {')
+    print('    "%s"' % inv)
+    print('}')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,622 @@
+/*
+ * rt_heapprof.c — sampling heap profiler for Blood programs.
+ *
+ * Records a call stack for roughly one allocation in every `rate` bytes
+ * (Poisson sampling, as in tcmalloc): each thread draws the distance to
+ * its next sample from an exponential distribution with mean `rate`, so
+ * large allocations are always caught and the expected sampled bytes are
+ * proportional to the bytes allocated at every site.
+ *
+ * The allocation paths in alloc.blood and rt_region.blood test one flag
+ * (HEAPPROF_ON, flipped through blood_heapprof_set_enabled) and only call
+ * in here while profiling is on. Each sample keeps its stack, tier and
+ * whether it came from a region. Samples are live until the object is
+ * freed, reallocated or its region is destroyed or reset.
+ *
+ * Enabling:
+ *   BLOOD_HEAP_PROFILE=<path>       profile from startup, write at exit
+ *   BLOOD_HEAP_PROFILE_RATE=<bytes> mean sampling interval (default 512 KiB)
+ * or call blood_heapprof_start / blood_heapprof_dump directly.
+ *
+ * Output format follows the path:
+ *   *.folded   folded stacks of estimated in-use bytes, for flamegraph.pl
+ *              and speedscope ("tier2;heap;main;...;leaf <bytes>")
+ *   otherwise  the pprof legacy heap profile ("heap_v2/<rate>"), which
+ *              `pprof <binary> <file>` reads and unsamples; both in-use
+ *              and allocated space are recorded
+ *
+ * Build:
+ *   clang-18 -c -O2 -fPIC runtime/blood-runtime/rt_heapprof.c \
+ *     -o build/rt_heapprof.o
+ *
+ * Copyright: follows Blood project license.
+ */
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <elf.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Exported by alloc.blood: turns the allocation-path hooks on or off. */
+extern void blood_heapprof_set_enabled(int32_t on);
+
+#define HP_DEFAULT_RATE  (512 * 1024)
+#define HP_MAX_DEPTH     48
+
+/* ========================================================================
+ * 1. State
+ * ======================================================================== */
+
+typedef struct {
+    uint64_t hash;
+    int32_t  depth;
+    int32_t  tier;
+    int32_t  in_region;
+    void*    pcs[HP_MAX_DEPTH];   /* innermost first, as backtrace() */
+    /* Raw sample sums; scaled to estimates only on output. */
+    int64_t  alloc_samples;
+    int64_t  alloc_bytes;
+    int64_t  inuse_samples;
+    int64_t  inuse_bytes;
+} hp_site;
+
+typedef struct {
+    uintptr_t addr;               /* 0 = empty */
+    int64_t   size;
+    int32_t   site;
+} hp_live;
+
+static pthread_mutex_t hp_lock = PTHREAD_MUTEX_INITIALIZER;
+static int64_t  hp_rate = 0;      /* 0 = off */
+static char*    hp_exit_path = NULL;
+
+static hp_site* hp_sites = NULL;
+static int32_t  hp_site_count = 0;
+static int32_t  hp_site_cap = 0;
+static int32_t* hp_site_index = NULL;   /* open addressing, -1 = empty */
+static int64_t  hp_site_index_cap = 0;
+
+static hp_live* hp_lives = NULL;        /* open addressing on addr */
+static int64_t  hp_live_count = 0;
+static int64_t  hp_live_cap = 0;
+
+/* Per-thread sampler: bytes until the next sample, and the PRNG. */
+static __thread int64_t  hp_countdown = 0;
+static __thread int32_t  hp_armed = 0;
+static __thread uint64_t hp_rng = 0;
+
+/* ========================================================================
+ * 2. Sampling intervals
+ * ======================================================================== */
+
+static uint64_t hp_next_random(void) {
+    if (hp_rng == 0) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        hp_rng = ((uint64_t)ts.tv_nsec * 0x9E3779B97F4A7C15ULL)
+               ^ (uint64_t)(uintptr_t)&hp_rng;
+        if (hp_rng == 0) {
+            hp_rng = 0x2545F4914F6CDD1DULL;
+        }
+    }
+    /* xorshift64* */
+    hp_rng ^= hp_rng >> 12;
+    hp_rng ^= hp_rng << 25;
+    hp_rng ^= hp_rng >> 27;
+    return hp_rng * 0x2545F4914F6CDD1DULL;
+}
+
+/* Exponentially distributed with mean hp_rate, at least 1. */
+static int64_t hp_next_interval(void) {
+    double u = ((double)(hp_next_random() >> 11) + 1.0) * (1.0 / 9007199254740992.0);
+    double bytes = -log(u) * (double)hp_rate;
+    if (bytes < 1.0) {
+        return 1;
+    }
+    if (bytes > 9.0e18) {
+        return INT64_MAX;
+    }
+    return (int64_t)bytes;
+}
+
+/* Expected number of bytes a sample of `bytes` over `samples` stands for. */
+static double hp_scale(int64_t samples, int64_t bytes) {
+    if (samples <= 0 || bytes <= 0 || hp_rate <= 0) {
+        return 0.0;
+    }
+    double avg = (double)bytes / (double)samples;
+    return (double)bytes / (1.0 - exp(-avg / (double)hp_rate));
+}
+
+/* ========================================================================
+ * 3. Tables
+ * ======================================================================== */
+
+static uint64_t hp_hash_stack(void* const* pcs, int32_t depth, int32_t tier, int32_t in_region) {
+    uint64_t h = 14695981039346656037ULL;
+    for (int32_t i = 0; i < depth; i++) {
+        h = (h ^ (uint64_t)(uintptr_t)pcs[i]) * 1099511628211ULL;
+    }
+    h = (h ^ (uint64_t)tier) * 1099511628211ULL;
+    h = (h ^ (uint64_t)in_region) * 1099511628211ULL;
+    return h;
+}
+
+static int hp_site_grow_index(void) {
+    int64_t cap = hp_site_index_cap == 0 ? 256 : hp_site_index_cap * 2;
+    int32_t* index = malloc((size_t)cap * sizeof(int32_t));
+    if (index == NULL) {
+        return 0;
+    }
+    memset(index, 0xFF, (size_t)cap * sizeof(int32_t));
+    for (int32_t s = 0; s < hp_site_count; s++) {
+        int64_t slot = (int64_t)(hp_sites[s].hash & (uint64_t)(cap - 1));
+        while (index[slot] >= 0) {
+            slot = (slot + 1) & (cap - 1);
+        }
+        index[slot] = s;
+    }
+    free(hp_site_index);
+    hp_site_index = index;
+    hp_site_index_cap = cap;
+    return 1;
+}
+
+/* Site for this stack, created on first use. Returns -1 when out of memory. */
+static int32_t hp_site_for(void* const* pcs, int32_t depth, int32_t tier, int32_t in_region) {
+    uint64_t hash = hp_hash_stack(pcs, depth, tier, in_region);
+    if ((int64_t)(hp_site_count + 1) * 4 > hp_site_index_cap * 3 && !hp_site_grow_index()) {
+        return -1;
+    }
+    int64_t slot = (int64_t)(hash & (uint64_t)(hp_site_index_cap - 1));
+    while (hp_site_index[slot] >= 0) {
+        hp_site* site = &hp_sites[hp_site_index[slot]];
+        if (site->hash == hash && site->depth == depth && site->tier == tier
+            && site->in_region == in_region
+            && memcmp(site->pcs, pcs, (size_t)depth * sizeof(void*)) == 0) {
+            return hp_site_index[slot];
+        }
+        slot = (slot + 1) & (hp_site_index_cap - 1);
+    }
+
+    if (hp_site_count == hp_site_cap) {
+        int32_t cap = hp_site_cap == 0 ? 128 : hp_site_cap * 2;
+        hp_site* sites = realloc(hp_sites, (size_t)cap * sizeof(hp_site));
+        if (sites == NULL) {
+            return -1;
+        }
+        hp_sites = sites;
+        hp_site_cap = cap;
+    }
+    int32_t id = hp_site_count++;
+    hp_site* site = &hp_sites[id];
+    memset(site, 0, sizeof(*site));
+    site->hash = hash;
+    site->depth = depth;
+    site->tier = tier;
+    site->in_region = in_region;
+    memcpy(site->pcs, pcs, (size_t)depth * sizeof(void*));
+    hp_site_index[slot] = id;
+    return id;
+}
+
+static int64_t hp_live_slot(uintptr_t addr, int64_t cap) {
+    return (int64_t)(((uint64_t)addr * 0x9E3779B97F4A7C15ULL) >> 20) & (cap - 1);
+}
+
+static int hp_live_grow(void) {
+    int64_t cap = hp_live_cap == 0 ? 1024 : hp_live_cap * 2;
+    hp_live* lives = calloc((size_t)cap, sizeof(hp_live));
+    if (lives == NULL) {
+        return 0;
+    }
+    for (int64_t i = 0; i < hp_live_cap; i++) {
+        if (hp_lives[i].addr != 0) {
+            int64_t slot = hp_live_slot(hp_lives[i].addr, cap);
+            while (lives[slot].addr != 0) {
+                slot = (slot + 1) & (cap - 1);
+            }
+            lives[slot] = hp_lives[i];
+        }
+    }
+    free(hp_lives);
+    hp_lives = lives;
+    hp_live_cap = cap;
+    return 1;
+}
+
+/* Removes the entry at `slot`, shifting later probes back (no tombstones). */
+static void hp_live_remove_at(int64_t slot) {
+    hp_live* gone = &hp_lives[slot];
+    hp_site* site = &hp_sites[gone->site];
+    site->inuse_samples -= 1;
+    site->inuse_bytes -= gone->size;
+    hp_live_count -= 1;
+
+    int64_t hole = slot;
+    int64_t next = (slot + 1) & (hp_live_cap - 1);
+    while (hp_lives[next].addr != 0) {
+        int64_t home = hp_live_slot(hp_lives[next].addr, hp_live_cap);
+        /* Move `next` into the hole unless its home lies in (hole, next]. */
+        int64_t dist_next = (next - home) & (hp_live_cap - 1);
+        int64_t dist_hole = (hole - home) & (hp_live_cap - 1);
+        if (dist_hole < dist_next) {
+            hp_lives[hole] = hp_lives[next];
+            hole = next;
+        }
+        next = (next + 1) & (hp_live_cap - 1);
+    }
+    hp_lives[hole].addr = 0;
+}
+
+/* ========================================================================
+ * 4. Allocation hooks (called from alloc.blood / rt_region.blood)
+ * ======================================================================== */
+
+static void hp_record(void* const* pcs, int32_t depth, uintptr_t addr, int64_t size,
+                      int32_t tier, int32_t in_region) {
+    pthread_mutex_lock(&hp_lock);
+    if (hp_rate > 0) {
+        int32_t id = hp_site_for(pcs, depth, tier, in_region);
+        if (id >= 0) {
+            hp_site* site = &hp_sites[id];
+            site->alloc_samples += 1;
+            site->alloc_bytes += size;
+            if ((hp_live_count + 1) * 4 <= hp_live_cap * 3 || hp_live_grow()) {
+                int64_t slot = hp_live_slot(addr, hp_live_cap);
+                while (hp_lives[slot].addr != 0 && hp_lives[slot].addr != addr) {
+                    slot = (slot + 1) & (hp_live_cap - 1);
+                }
+                if (hp_lives[slot].addr == addr) {
+                    /* Freed behind our back (e.g. region memory reused). */
+                    hp_live_remove_at(slot);
+                    slot = hp_live_slot(addr, hp_live_cap);
+                    while (hp_lives[slot].addr != 0) {
+                        slot = (slot + 1) & (hp_live_cap - 1);
+                    }
+                }
+                hp_lives[slot].addr = addr;
+                hp_lives[slot].size = size;
+                hp_lives[slot].site = id;
+                hp_live_count += 1;
+                site->inuse_samples += 1;
+                site->inuse_bytes += size;
+            }
+        }
+    }
+    pthread_mutex_unlock(&hp_lock);
+}
+
+/*
+ * Account `size` bytes allocated at `addr`. `region` is the region id the
+ * memory came from (0 = heap); `tier` is the memory tier (2 = region or
+ * heap, 3 = persistent). Only reached while profiling is on.
+ */
+void blood_heapprof_alloc(int64_t addr, int64_t size, int64_t region, int32_t tier) {
+    if (hp_rate <= 0 || addr == 0) {
+        return;
+    }
+    if (!hp_armed) {
+        hp_countdown = hp_next_interval();
+        hp_armed = 1;
+    }
+    hp_countdown -= size;
+    if (hp_countdown >= 0) {
+        return;
+    }
+    hp_countdown = hp_next_interval();
+
+    /* Captured here, not in a helper, so frame 0 is always this function. */
+    void* frames[HP_MAX_DEPTH + 1];
+    int depth = backtrace(frames, HP_MAX_DEPTH + 1) - 1;
+    if (depth < 0) {
+        depth = 0;
+    }
+    hp_record(frames + 1, depth, (uintptr_t)addr, size, tier, region != 0 ? 1 : 0);
+}
+
+/* The object at `addr` is gone; drop its sample, if it has one. */
+void blood_heapprof_free(int64_t addr) {
+    if (hp_live_count == 0) {
+        return;
+    }
+    pthread_mutex_lock(&hp_lock);
+    if (hp_live_cap > 0) {
+        int64_t slot = hp_live_slot((uintptr_t)addr, hp_live_cap);
+        while (hp_lives[slot].addr != 0) {
+            if (hp_lives[slot].addr == (uintptr_t)addr) {
+                hp_live_remove_at(slot);
+                break;
+            }
+            slot = (slot + 1) & (hp_live_cap - 1);
+        }
+    }
+    pthread_mutex_unlock(&hp_lock);
+}
+
+/* Everything in [lo, hi) is gone: a region was destroyed or reset. */
+void blood_heapprof_release_range(int64_t lo, int64_t hi) {
+    if (hp_live_count == 0) {
+        return;
+    }
+    pthread_mutex_lock(&hp_lock);
+    int64_t i = 0;
+    while (i < hp_live_cap) {
+        uintptr_t addr = hp_lives[i].addr;
+        if (addr != 0 && addr >= (uintptr_t)lo && addr < (uintptr_t)hi) {
+            /* Removal may shift a later entry into slot i; look again. */
+            hp_live_remove_at(i);
+        } else {
+            i++;
+        }
+    }
+    pthread_mutex_unlock(&hp_lock);
+}
+
+/* ========================================================================
+ * 5. Symbolization (folded output)
+ *
+ * dladdr only sees the dynamic symbol table, which a non -rdynamic PIE
+ * leaves empty, so the main executable's .symtab is read directly.
+ * ======================================================================== */
+
+typedef struct {
+    uintptr_t start;
+    uintptr_t size;
+    const char* name;
+} hp_sym;
+
+static hp_sym* hp_exe_syms = NULL;
+static int64_t hp_exe_sym_count = 0;
+static const char* hp_exe_base = NULL;
+static int hp_exe_loaded = 0;
+
+static int hp_sym_cmp(const void* a, const void* b) {
+    uintptr_t x = ((const hp_sym*)a)->start;
+    uintptr_t y = ((const hp_sym*)b)->start;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/* Loads the function symbols of `path`. The file stays mapped. */
+static void hp_load_symbols(const char* path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Elf64_Ehdr)) {
+        close(fd);
+        return;
+    }
+    const char* image = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        return;
+    }
+    const Elf64_Ehdr* eh = (const Elf64_Ehdr*)image;
+    if (memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0 || eh->e_ident[EI_CLASS] != ELFCLASS64
+        || eh->e_shoff == 0
+        || eh->e_shoff + (uint64_t)eh->e_shnum * sizeof(Elf64_Shdr) > (uint64_t)st.st_size) {
+        return;
+    }
+    const Elf64_Shdr* sections = (const Elf64_Shdr*)(image + eh->e_shoff);
+    for (int i = 0; i < eh->e_shnum; i++) {
+        if (sections[i].sh_type != SHT_SYMTAB || sections[i].sh_link >= eh->e_shnum) {
+            continue;
+        }
+        const Elf64_Shdr* strtab = &sections[sections[i].sh_link];
+        const Elf64_Sym* syms = (const Elf64_Sym*)(image + sections[i].sh_offset);
+        int64_t count = (int64_t)(sections[i].sh_size / sizeof(Elf64_Sym));
+        hp_exe_syms = malloc((size_t)count * sizeof(hp_sym));
+        if (hp_exe_syms == NULL) {
+            return;
+        }
+        for (int64_t s = 0; s < count; s++) {
+            if (ELF64_ST_TYPE(syms[s].st_info) != STT_FUNC || syms[s].st_value == 0
+                || syms[s].st_name >= strtab->sh_size) {
+                continue;
+            }
+            hp_sym* sym = &hp_exe_syms[hp_exe_sym_count++];
+            sym->start = (uintptr_t)syms[s].st_value;
+            sym->size = (uintptr_t)syms[s].st_size;
+            sym->name = image + strtab->sh_offset + syms[s].st_name;
+        }
+        qsort(hp_exe_syms, (size_t)hp_exe_sym_count, sizeof(hp_sym), hp_sym_cmp);
+        return;
+    }
+}
+
+/* Writes a name for return address `pc` into `out`. */
+static void hp_symbolize(void* pc, char* out, size_t len) {
+    /* A return address may sit just past its caller's last byte. */
+    uintptr_t addr = (uintptr_t)pc - 1;
+    Dl_info info;
+    if (dladdr((void*)addr, &info) == 0 || info.dli_fname == NULL) {
+        snprintf(out, len, "0x%lx", (unsigned long)(uintptr_t)pc);
+        return;
+    }
+    if (info.dli_sname != NULL) {
+        snprintf(out, len, "%s", info.dli_sname);
+        return;
+    }
+    if (!hp_exe_loaded) {
+        Dl_info self;
+        hp_exe_loaded = 1;
+        if (dladdr((void*)&hp_symbolize, &self) != 0) {
+            hp_exe_base = (const char*)self.dli_fbase;
+            hp_load_symbols("/proc/self/exe");
+        }
+    }
+    if ((const char*)info.dli_fbase == hp_exe_base && hp_exe_sym_count > 0) {
+        uintptr_t rel = addr - (uintptr_t)info.dli_fbase;
+        int64_t lo = 0;
+        int64_t hi = hp_exe_sym_count;
+        while (lo < hi) {
+            int64_t mid = (lo + hi) / 2;
+            if (hp_exe_syms[mid].start <= rel) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo > 0) {
+            const hp_sym* sym = &hp_exe_syms[lo - 1];
+            if (sym->size == 0 || rel < sym->start + sym->size) {
+                snprintf(out, len, "%s", sym->name);
+                return;
+            }
+        }
+    }
+    const char* file = strrchr(info.dli_fname, '/');
+    snprintf(out, len, "%s+0x%lx", file != NULL ? file + 1 : info.dli_fname,
+             (unsigned long)(addr - (uintptr_t)info.dli_fbase));
+}
+
+/* ========================================================================
+ * 6. Output
+ * ======================================================================== */
+
+static int hp_ends_with(const char* s, const char* suffix) {
+    size_t n = strlen(s);
+    size_t m = strlen(suffix);
+    return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+static void hp_write_folded(FILE* out) {
+    char name[256];
+    for (int32_t s = 0; s < hp_site_count; s++) {
+        const hp_site* site = &hp_sites[s];
+        double bytes = hp_scale(site->inuse_samples, site->inuse_bytes);
+        if (bytes < 0.5) {
+            continue;
+        }
+        /* Root first; frames above `main` are libc startup. */
+        int32_t top = site->depth - 1;
+        for (int32_t f = 0; f < site->depth; f++) {
+            hp_symbolize(site->pcs[f], name, sizeof(name));
+            if (strcmp(name, "main") == 0) {
+                top = f;
+                break;
+            }
+        }
+        fprintf(out, "tier%d;%s", site->tier, site->in_region ? "region" : "heap");
+        for (int32_t f = top; f >= 0; f--) {
+            hp_symbolize(site->pcs[f], name, sizeof(name));
+            for (char* c = name; *c != '\0'; c++) {
+                if (*c == ';' || *c == ' ') {
+                    *c = '_';
+                }
+            }
+            fprintf(out, ";%s", name);
+        }
+        fprintf(out, " %lld\n", (long long)(bytes + 0.5));
+    }
+}
+
+static void hp_write_pprof(FILE* out) {
+    int64_t inuse_n = 0, inuse_b = 0, alloc_n = 0, alloc_b = 0;
+    for (int32_t s = 0; s < hp_site_count; s++) {
+        inuse_n += hp_sites[s].inuse_samples;
+        inuse_b += hp_sites[s].inuse_bytes;
+        alloc_n += hp_sites[s].alloc_samples;
+        alloc_b += hp_sites[s].alloc_bytes;
+    }
+    fprintf(out, "heap profile: %lld: %lld [%lld: %lld] @ heap_v2/%lld\n",
+            (long long)inuse_n, (long long)inuse_b, (long long)alloc_n,
+            (long long)alloc_b, (long long)hp_rate);
+    for (int32_t s = 0; s < hp_site_count; s++) {
+        const hp_site* site = &hp_sites[s];
+        fprintf(out, "%lld: %lld [%lld: %lld] @",
+                (long long)site->inuse_samples, (long long)site->inuse_bytes,
+                (long long)site->alloc_samples, (long long)site->alloc_bytes);
+        for (int32_t f = 0; f < site->depth; f++) {
+            fprintf(out, " %p", site->pcs[f]);
+        }
+        fputc('\n', out);
+    }
+    fputs("\nMAPPED_LIBRARIES:\n", out);
+    FILE* maps = fopen("/proc/self/maps", "r");
+    if (maps != NULL) {
+        char buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), maps)) > 0) {
+            fwrite(buf, 1, n, out);
+        }
+        fclose(maps);
+    }
+}
+
+/*
+ * Write the current profile to `path` (format chosen by extension, see
+ * the file comment). Returns 0 on success, -1 if the file can't be written.
+ */
+int32_t blood_heapprof_dump(const char* path) {
+    if (path == NULL) {
+        return -1;
+    }
+    FILE* out = fopen(path, "w");
+    if (out == NULL) {
+        return -1;
+    }
+    pthread_mutex_lock(&hp_lock);
+    if (hp_ends_with(path, ".folded")) {
+        hp_write_folded(out);
+    } else {
+        hp_write_pprof(out);
+    }
+    pthread_mutex_unlock(&hp_lock);
+    return fclose(out) == 0 ? 0 : -1;
+}
+
+/* ========================================================================
+ * 7. Control
+ * ======================================================================== */
+
+/* Start sampling every `rate` bytes on average (<= 0: the default). */
+void blood_heapprof_start(int64_t rate) {
+    void* warm[1];
+    /* backtrace() loads libgcc on first use; do that outside any sample. */
+    backtrace(warm, 1);
+    pthread_mutex_lock(&hp_lock);
+    hp_rate = rate > 0 ? rate : HP_DEFAULT_RATE;
+    pthread_mutex_unlock(&hp_lock);
+    blood_heapprof_set_enabled(1);
+}
+
+/* Stop sampling. Recorded samples are kept and can still be dumped. */
+void blood_heapprof_stop(void) {
+    blood_heapprof_set_enabled(0);
+    pthread_mutex_lock(&hp_lock);
+    hp_rate = 0;
+    pthread_mutex_unlock(&hp_lock);
+}
+
+static void hp_dump_at_exit(void) {
+    if (hp_exit_path != NULL && blood_heapprof_dump(hp_exit_path) != 0) {
+        fprintf(stderr, "blood: could not write heap profile to %s\n", hp_exit_path);
+    }
+}
+
+/* BLOOD_HEAP_PROFILE=<path> profiles the whole run. */
+__attribute__((constructor))
+static void hp_init_from_env(void) {
+    const char* path = getenv("BLOOD_HEAP_PROFILE");
+    if (path == NULL || path[0] == '\0') {
+        return;
+    }
+    const char* rate = getenv("BLOOD_HEAP_PROFILE_RATE");
+    hp_exit_path = strdup(path);
+    blood_heapprof_start(rate != NULL ? strtoll(rate, NULL, 10) : 0);
+    atexit(hp_dump_at_exit);
+}
@@ -128,6 +128,49 @@ fn bench_continuation_registry(c: &mut Criterion) {
     group.finish();
 }
 
+/// Benchmark concurrent register/take pairs from 1 to 32 threads.
+///
+/// Each thread performs `iters` register/take cycles; the reported time is
+/// the wall-clock time for all threads, so flat timings across thread
+/// counts mean the registry scales linearly.
+fn bench_continuation_registry_concurrent(c: &mut Criterion) {
+    let mut group = c.benchmark_group("continuation_registry_concurrent");
+
+    for threads in [1usize, 2, 4, 8, 16, 32] {
+        group.throughput(Throughput::Elements(threads as u64));
+        group.bench_with_input(
+            BenchmarkId::new("register_take_pairs", threads),
+            &threads,
+            |b, &threads| {
+                b.iter_custom(|iters| {
+                    let barrier = std::sync::Arc::new(std::sync::Barrier::new(threads + 1));
+                    let handles: Vec<_> = (0..threads)
+                        .map(|_| {
+                            let barrier = barrier.clone();
+                            std::thread::spawn(move || {
+                                barrier.wait();
+                                for _ in 0..iters {
+                                    let k = Continuation::new(|x: i32| x);
+                                    let r = register_continuation(k);
+                                    black_box(take_continuation(r));
+                                }
+                            })
+                        })
+                        .collect();
+                    barrier.wait();
+                    let start = std::time::Instant::now();
+                    for h in handles {
+                        h.join().unwrap();
+                    }
+                    start.elapsed()
+                });
+            },
+        );
+    }
+
+    group.finish();
+}
+
 /// Benchmark EffectContext operations
 fn bench_effect_context(c: &mut Criterion) {
     let mut group = c.benchmark_group("effect_context");
@@ -485,6 +528,7 @@ criterion_group!(
     bench_continuation_creation,
     bench_continuation_resume,
     bench_continuation_registry,
+    bench_continuation_registry_concurrent,
     bench_effect_context,
     bench_generation_snapshot,
     bench_snapshot_validation,
@@ -3,6 +3,7 @@
 //! Run with: cargo bench --bench scheduler_bench
 
 use blood_runtime::fiber::{Fiber, FiberConfig, FiberState};
+use blood_runtime::fiber_local::{FiberContext, FiberLocalStorage, PropagatedLocal, TraceContext};
 use blood_runtime::scheduler::Scheduler;
 use blood_runtime::SchedulerConfig;
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
@@ -148,6 +149,42 @@ fn bench_concurrent_counter(c: &mut Criterion) {
     group.finish();
 }
 
+fn bench_fiber_local(c: &mut Criterion) {
+    let mut group = c.benchmark_group("fiber_local");
+
+    // Eight propagated tracing values, as a request handler would carry.
+    let locals: Vec<PropagatedLocal<TraceContext>> =
+        (0..8).map(|_| PropagatedLocal::new_copied()).collect();
+    let mut storage = FiberLocalStorage::new();
+    FiberContext::with_storage(&mut storage, || {
+        let root = TraceContext::new_root();
+        for local in &locals {
+            local.set(root.child_span());
+        }
+    });
+
+    // Spawn a child fiber that inherits all eight values
+    group.bench_function("spawn_with_8_propagated", |b| {
+        FiberContext::with_storage(&mut storage, || {
+            b.iter(|| black_box(Fiber::new(|| {}, FiberConfig::default())));
+        });
+    });
+
+    // Look up each of the eight values from inside a fiber
+    group.throughput(Throughput::Elements(locals.len() as u64));
+    group.bench_function("lookup_8_propagated", |b| {
+        FiberContext::with_storage(&mut storage, || {
+            b.iter(|| {
+                for local in &locals {
+                    black_box(local.get());
+                }
+            });
+        });
+    });
+
+    group.finish();
+}
+
 criterion_group!(
     benches,
     bench_fiber_creation,
@@ -155,5 +192,6 @@ criterion_group!(
     bench_fiber_state_transitions,
     bench_scheduler_config,
     bench_concurrent_counter,
+    bench_fiber_local,
 );
 criterion_main!(benches);
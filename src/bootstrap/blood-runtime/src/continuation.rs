@@ -28,6 +28,7 @@
 //!
 //! Multi-shot continuations can be added later using explicit `clone` operations.
 
+use crossbeam_utils::CachePadded;
 use parking_lot::Mutex;
 use std::any::Any;
 use std::collections::HashMap;
@@ -218,21 +219,36 @@ impl ContinuationRef {
     }
 }
 
+/// Number of registry shards. Must be a power of two.
+const REGISTRY_SHARDS: usize = 64;
+
+/// One shard of the continuation registry, padded to its own cache line so
+/// that workers hitting neighbouring shards do not false-share.
+type RegistryShard = CachePadded<Mutex<HashMap<u64, Continuation>>>;
+
 /// Global continuation registry.
 ///
-/// Stores captured continuations by ID for later resumption.
-static CONTINUATION_REGISTRY: OnceLock<Mutex<HashMap<u64, Continuation>>> = OnceLock::new();
-
-/// Get or initialize the continuation registry.
-fn get_continuation_registry() -> &'static Mutex<HashMap<u64, Continuation>> {
-    CONTINUATION_REGISTRY.get_or_init(|| Mutex::new(HashMap::new()))
+/// Stores captured continuations by ID for later resumption. The map is
+/// split into `REGISTRY_SHARDS` independently locked shards selected by the
+/// low bits of the ID. IDs come from a single counter, so concurrent
+/// captures spread round-robin across shards, while a register/take pair
+/// for the same continuation always meets in the same shard.
+static CONTINUATION_REGISTRY: OnceLock<Box<[RegistryShard]>> = OnceLock::new();
+
+/// Get the registry shard that owns continuation `id`.
+fn registry_shard(id: u64) -> &'static Mutex<HashMap<u64, Continuation>> {
+    let shards = CONTINUATION_REGISTRY.get_or_init(|| {
+        (0..REGISTRY_SHARDS)
+            .map(|_| CachePadded::new(Mutex::new(HashMap::new())))
+            .collect()
+    });
+    &shards[(id as usize) & (REGISTRY_SHARDS - 1)]
 }
 
 /// Register a continuation and get its reference.
 pub fn register_continuation(k: Continuation) -> ContinuationRef {
     let id = k.id().as_u64();
-    let mut registry = get_continuation_registry().lock();
-    registry.insert(id, k);
+    registry_shard(id).lock().insert(id, k);
     ContinuationRef { id }
 }
 
@@ -240,14 +256,12 @@ pub fn register_continuation(k: Continuation) -> ContinuationRef {
 ///
 /// Removes and returns the continuation, or `None` if not found.
 pub fn take_continuation(r: ContinuationRef) -> Option<Continuation> {
-    let mut registry = get_continuation_registry().lock();
-    registry.remove(&r.id)
+    registry_shard(r.id).lock().remove(&r.id)
 }
 
 /// Check if a continuation exists in the registry.
 pub fn has_continuation(r: ContinuationRef) -> bool {
-    let registry = get_continuation_registry().lock();
-    registry.contains_key(&r.id)
+    registry_shard(r.id).lock().contains_key(&r.id)
 }
 
 // ============================================================================
@@ -482,6 +496,26 @@ mod tests {
         assert!(!has_continuation(r));
     }
 
+    #[test]
+    fn test_continuation_registry_concurrent() {
+        let handles: Vec<_> = (0..8)
+            .map(|t| {
+                std::thread::spawn(move || {
+                    for i in 0..1000 {
+                        let r = register_continuation(Continuation::new(move |x: i32| x + t + i));
+                        let k = take_continuation(r).expect("continuation should exist");
+                        let result: i32 = k.resume(1);
+                        assert_eq!(result, 1 + t + i);
+                        assert!(!has_continuation(r));
+                    }
+                })
+            })
+            .collect();
+        for h in handles {
+            h.join().expect("worker panicked");
+        }
+    }
+
     #[test]
     fn test_effect_context_default() {
         let ctx = EffectContext::default();
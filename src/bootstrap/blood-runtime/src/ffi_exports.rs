@@ -21,7 +21,7 @@
 use std::cell::{Cell, RefCell, UnsafeCell};
 use std::collections::HashMap;
 use std::ffi::{c_char, c_int, c_void, CStr};
-use std::io::{self, Write};
+use std::io::Write;
 use std::sync::OnceLock;
 
 use parking_lot::Mutex;
@@ -41,6 +41,9 @@ use crate::memory::{
     slot_size_for_class, system_alloc_live_bytes, system_alloc_stats, unregister_allocation,
     BloodPtr, PointerMetadata, Region, SIZE_CLASS_LARGE,
 };
+use crate::stdio;
+// Runtime diagnostics flush this thread's stdout before writing stderr.
+use crate::stdio::eprintln;
 
 /// Fiber handle for continuation capture.
 pub type FiberHandle = u64;
@@ -238,7 +241,7 @@ pub unsafe extern "C" fn blood_handler_push_abort_target(jmpbuf_ptr: *mut u8) {
             "BLOOD RUNTIME ERROR: handler abort target stack overflow (depth {})",
             depth
         );
-        std::process::abort();
+        stdio::abort();
     }
     ABORT_TARGETS.with(|targets| {
         let arr = &mut *targets.get();
@@ -284,7 +287,7 @@ pub unsafe extern "C" fn blood_handler_abort(value: i64) -> ! {
     let depth = ABORT_DEPTH.with(|d| d.get());
     if depth == 0 {
         eprintln!("BLOOD RUNTIME ERROR: handler abort with no abort target");
-        std::process::abort();
+        stdio::abort();
     }
     let idx = depth - 1;
     let jmpbuf_ptr = ABORT_TARGETS.with(|targets| {
@@ -455,32 +458,31 @@ pub extern "C" fn blood_region_active_id() -> u64 {
 /// Print an integer (no newline).
 #[no_mangle]
 pub extern "C" fn print_int(n: i32) {
-    print!("{n}");
-    let _ = io::stdout().flush();
+    stdio::print_i64(n as i64, false);
 }
 
 /// Print an integer with newline.
 #[no_mangle]
 pub extern "C" fn println_int(n: i32) {
-    println!("{n}");
+    stdio::print_i64(n as i64, true);
 }
 
 /// Print a 64-bit integer with newline.
 #[no_mangle]
 pub extern "C" fn println_i64(n: i64) {
-    println!("{n}");
+    stdio::print_i64(n, true);
 }
 
 /// Print just a newline.
 #[no_mangle]
 pub extern "C" fn println() {
-    println!();
+    stdio::println_bytes(b"");
 }
 
 /// Print just a newline (alias for println).
 #[no_mangle]
 pub extern "C" fn print_newline() {
-    println!();
+    stdio::println_bytes(b"");
 }
 
 /// Blood str slice representation {ptr, len}.
@@ -798,9 +800,8 @@ pub unsafe extern "C" fn string_substring(
 pub unsafe extern "C" fn print_str(s: BloodStr) {
     if !s.ptr.is_null() && s.len > 0 {
         let slice = std::slice::from_raw_parts(s.ptr, s.len as usize);
-        if let Ok(str_val) = std::str::from_utf8(slice) {
-            print!("{str_val}");
-            let _ = io::stdout().flush();
+        if std::str::from_utf8(slice).is_ok() {
+            stdio::print_bytes(slice);
         }
     }
 }
@@ -815,12 +816,12 @@ pub unsafe extern "C" fn print_str(s: BloodStr) {
 pub unsafe extern "C" fn println_str(s: BloodStr) {
     if !s.ptr.is_null() && s.len > 0 {
         let slice = std::slice::from_raw_parts(s.ptr, s.len as usize);
-        if let Ok(str_val) = std::str::from_utf8(slice) {
-            println!("{str_val}");
+        if std::str::from_utf8(slice).is_ok() {
+            stdio::println_bytes(slice);
         }
     } else {
         // Empty string - just print newline
-        println!();
+        stdio::println_bytes(b"");
     }
 }
 
@@ -832,12 +833,10 @@ pub unsafe extern "C" fn println_str(s: BloodStr) {
 /// The pointer must be valid for `len` bytes.
 #[no_mangle]
 pub unsafe extern "C" fn eprint_str(s: BloodStr) {
-    use std::io::Write;
     if !s.ptr.is_null() && s.len > 0 {
         let slice = std::slice::from_raw_parts(s.ptr, s.len as usize);
-        if let Ok(str_val) = std::str::from_utf8(slice) {
-            eprint!("{str_val}");
-            let _ = std::io::stderr().flush();
+        if std::str::from_utf8(slice).is_ok() {
+            stdio::eprint_bytes(slice, false);
         }
     }
 }
@@ -852,12 +851,12 @@ pub unsafe extern "C" fn eprint_str(s: BloodStr) {
 pub unsafe extern "C" fn eprintln_str(s: BloodStr) {
     if !s.ptr.is_null() && s.len > 0 {
         let slice = std::slice::from_raw_parts(s.ptr, s.len as usize);
-        if let Ok(str_val) = std::str::from_utf8(slice) {
-            eprintln!("{str_val}");
+        if std::str::from_utf8(slice).is_ok() {
+            stdio::eprint_bytes(slice, true);
         }
     } else {
         // Empty string - just print newline
-        eprintln!();
+        stdio::eprint_bytes(b"", true);
     }
 }
 
@@ -1779,6 +1778,7 @@ pub extern "C" fn read_line() -> BloodStr {
         static LINE_BUFFER: RefCell<Vec<u8>> = const { RefCell::new(Vec::new()) };
     }
 
+    stdio::flush_stdout();
     let stdin = std::io::stdin();
     let mut handle = stdin.lock();
 
@@ -1825,6 +1825,7 @@ pub extern "C" fn read_line() -> BloodStr {
 pub extern "C" fn read_int() -> i32 {
     use std::io::BufRead;
 
+    stdio::flush_stdout();
     let stdin = std::io::stdin();
     let mut handle = stdin.lock();
     let mut line = String::new();
@@ -5582,7 +5583,7 @@ pub extern "C" fn blood_continuation_resume(continuation: ContinuationHandle, va
                      (continuation callback returned None)",
                     continuation
                 );
-                std::process::abort();
+                stdio::abort();
             }
         };
 
@@ -5606,7 +5607,7 @@ pub extern "C" fn blood_continuation_resume(continuation: ContinuationHandle, va
              For multi-shot semantics, use blood_continuation_clone before resuming.",
             continuation
         );
-        std::process::abort();
+        stdio::abort();
     }
 }
 
@@ -6053,6 +6054,7 @@ pub extern "C" fn blood_scheduler_wait() {
     if let Some(thread_holder) = SCHEDULER_THREAD.get() {
         let mut thread_guard = thread_holder.lock();
         if let Some(handle) = thread_guard.take() {
+            stdio::flush_stdout();
             let _ = handle.join();
         }
     }
@@ -6145,7 +6147,7 @@ pub extern "C" fn blood_stale_reference_panic(expected: u32, actual: u32) -> ! {
     );
     eprintln!("Backtrace:\n{}", std::backtrace::Backtrace::force_capture());
     eprintln!("Tip: resolve source lines with: addr2line -e <binary> -f <address>");
-    std::process::abort();
+    stdio::abort();
 }
 
 /// Called when snapshot validation fails during effect resume.
@@ -6181,7 +6183,7 @@ pub unsafe extern "C" fn blood_snapshot_stale_panic(
                  This indicates use-after-free while continuation was suspended. Aborting.",
                 entry.address, entry.generation, actual_gen
             );
-            std::process::abort();
+            stdio::abort();
         }
     }
 
@@ -6190,7 +6192,7 @@ pub unsafe extern "C" fn blood_snapshot_stale_panic(
          Snapshot validation failed at entry {}. Aborting.",
         stale_index
     );
-    std::process::abort();
+    stdio::abort();
 }
 
 /// Called on unrecoverable runtime errors.
@@ -6207,7 +6209,7 @@ pub unsafe extern "C" fn blood_panic(msg: *const c_char) -> ! {
     eprintln!("BLOOD RUNTIME PANIC: {message}");
     eprintln!("Backtrace:\n{}", std::backtrace::Backtrace::force_capture());
     eprintln!("Tip: resolve source lines with: addr2line -e <binary> -f <address>");
-    std::process::abort();
+    stdio::abort();
 }
 
 /// Called when a division or remainder operation has a zero divisor.
@@ -6216,7 +6218,7 @@ pub extern "C" fn blood_panic_div_zero() -> ! {
     eprintln!("BLOOD RUNTIME PANIC: division by zero");
     eprintln!("Backtrace:\n{}", std::backtrace::Backtrace::force_capture());
     eprintln!("Tip: resolve source lines with: addr2line -e <binary> -f <address>");
-    std::process::abort();
+    stdio::abort();
 }
 
 /// Called when an index is out of bounds for an array, slice, or Vec.
@@ -6228,7 +6230,7 @@ pub extern "C" fn blood_panic_index_out_of_bounds(index: i64, length: i64) -> !
     );
     eprintln!("Backtrace:\n{}", std::backtrace::Backtrace::force_capture());
     eprintln!("Tip: resolve source lines with: addr2line -e <binary> -f <address>");
-    std::process::abort();
+    stdio::abort();
 }
 
 /// Called when an index is out of bounds, with source location context.
@@ -6253,7 +6255,7 @@ pub unsafe extern "C" fn blood_panic_index_out_of_bounds_loc(
     eprintln!("  at: {}", loc);
     eprintln!("Backtrace:\n{}", std::backtrace::Backtrace::force_capture());
     eprintln!("Tip: resolve source lines with: addr2line -e <binary> -f <address>");
-    std::process::abort();
+    stdio::abort();
 }
 
 /// Panic with a Blood str slice message.
@@ -6269,7 +6271,7 @@ pub unsafe extern "C" fn panic(msg: BloodStr) -> ! {
         std::str::from_utf8(slice).unwrap_or("invalid UTF-8")
     };
     eprintln!("PANIC: {message}");
-    std::process::abort();
+    stdio::abort();
 }
 
 // ============================================================================
@@ -8506,7 +8508,7 @@ pub unsafe extern "C" fn vec_get_ptr(vec: *const BloodVec, index: i64, elem_size
             "Vec index out of bounds: index {} but len is {}",
             index, v.len
         );
-        std::process::abort();
+        stdio::abort();
     }
 
     v.ptr.add((index * elem_size) as usize)
@@ -12103,14 +12105,13 @@ pub unsafe extern "C" fn debug_local_enum(ptr: *const u8, name: *const u8, name_
 /// Print a boolean value without newline.
 #[no_mangle]
 pub extern "C" fn print_bool(val: bool) {
-    print!("{}", val);
-    let _ = io::stdout().flush();
+    stdio::print_bytes(if val { b"true" } else { b"false" });
 }
 
 /// Print a boolean value with newline.
 #[no_mangle]
 pub extern "C" fn println_bool(val: bool) {
-    println!("{}", val);
+    stdio::println_bytes(if val { b"true" } else { b"false" });
 }
 
 /// Print a character without newline.
@@ -12119,8 +12120,7 @@ pub extern "C" fn println_bool(val: bool) {
 #[no_mangle]
 pub extern "C" fn print_char(c: i32) {
     if let Some(ch) = char::from_u32(c as u32) {
-        print!("{}", ch);
-        let _ = io::stdout().flush();
+        stdio::print_bytes(ch.encode_utf8(&mut [0u8; 4]).as_bytes());
     }
 }
 
@@ -12130,60 +12130,56 @@ pub extern "C" fn print_char(c: i32) {
 #[no_mangle]
 pub extern "C" fn println_char(c: i32) {
     if let Some(ch) = char::from_u32(c as u32) {
-        println!("{}", ch);
+        stdio::println_bytes(ch.encode_utf8(&mut [0u8; 4]).as_bytes());
     }
 }
 
 /// Print a 32-bit float without newline.
 #[no_mangle]
 pub extern "C" fn print_f32(val: f32) {
-    print!("{}", val);
-    let _ = io::stdout().flush();
+    stdio::print_fmt(format_args!("{}", val), false);
 }
 
 /// Print a 32-bit float with newline.
 #[no_mangle]
 pub extern "C" fn println_f32(val: f32) {
-    println!("{}", val);
+    stdio::print_fmt(format_args!("{}", val), true);
 }
 
 /// Print a 64-bit float without newline.
 #[no_mangle]
 pub extern "C" fn print_f64(val: f64) {
-    print!("{}", val);
-    let _ = io::stdout().flush();
+    stdio::print_fmt(format_args!("{}", val), false);
 }
 
 /// Print a 64-bit float with newline.
 #[no_mangle]
 pub extern "C" fn println_f64(val: f64) {
-    println!("{}", val);
+    stdio::print_fmt(format_args!("{}", val), true);
 }
 
 /// Print a 32-bit float with specified decimal precision, without newline.
 #[no_mangle]
 pub extern "C" fn print_f32_prec(val: f32, prec: i32) {
-    print!("{:.1$}", val, prec as usize);
-    let _ = io::stdout().flush();
+    stdio::print_fmt(format_args!("{:.1$}", val, prec as usize), false);
 }
 
 /// Print a 32-bit float with specified decimal precision, with newline.
 #[no_mangle]
 pub extern "C" fn println_f32_prec(val: f32, prec: i32) {
-    println!("{:.1$}", val, prec as usize);
+    stdio::print_fmt(format_args!("{:.1$}", val, prec as usize), true);
 }
 
 /// Print a 64-bit float with specified decimal precision, without newline.
 #[no_mangle]
 pub extern "C" fn print_f64_prec(val: f64, prec: i32) {
-    print!("{:.1$}", val, prec as usize);
-    let _ = io::stdout().flush();
+    stdio::print_fmt(format_args!("{:.1$}", val, prec as usize), false);
 }
 
 /// Print a 64-bit float with specified decimal precision, with newline.
 #[no_mangle]
 pub extern "C" fn println_f64_prec(val: f64, prec: i32) {
-    println!("{:.1$}", val, prec as usize);
+    stdio::print_fmt(format_args!("{:.1$}", val, prec as usize), true);
 }
 
 /// Print an unsigned 64-bit integer without newline.
@@ -12191,8 +12187,7 @@ pub extern "C" fn println_f64_prec(val: f64, prec: i32) {
 /// In the Blood ABI, u64 is passed as i64. We reinterpret the bits.
 #[no_mangle]
 pub extern "C" fn print_u64(val: i64) {
-    print!("{}", val as u64);
-    let _ = io::stdout().flush();
+    stdio::print_u64(val as u64, false);
 }
 
 /// Print an unsigned 64-bit integer with newline.
@@ -12200,14 +12195,13 @@ pub extern "C" fn print_u64(val: i64) {
 /// In the Blood ABI, u64 is passed as i64. We reinterpret the bits.
 #[no_mangle]
 pub extern "C" fn println_u64(val: i64) {
-    println!("{}", val as u64);
+    stdio::print_u64(val as u64, true);
 }
 
 /// Print a 64-bit integer without newline.
 #[no_mangle]
 pub extern "C" fn print_i64(val: i64) {
-    print!("{}", val);
-    let _ = io::stdout().flush();
+    stdio::print_i64(val, false);
 }
 
 // ============================================================================
@@ -12549,7 +12543,7 @@ pub extern "C" fn ptr_write_f64(ptr: i64, val: f64) {
 pub extern "C" fn blood_assert(cond: i32) {
     if cond == 0 {
         eprintln!("BLOOD RUNTIME PANIC: assertion failed");
-        std::process::abort();
+        stdio::abort();
     }
 }
 
@@ -12561,7 +12555,7 @@ pub extern "C" fn blood_assert_eq_bool(a: bool, b: bool) {
             "BLOOD RUNTIME PANIC: assertion failed: bool values not equal ({} != {})",
             a, b
         );
-        std::process::abort();
+        stdio::abort();
     }
 }
 
@@ -12570,7 +12564,7 @@ pub extern "C" fn blood_assert_eq_bool(a: bool, b: bool) {
 pub extern "C" fn blood_assert_eq_int(a: i32, b: i32) {
     if a != b {
         eprintln!("BLOOD RUNTIME PANIC: assertion failed: {} != {}", a, b);
-        std::process::abort();
+        stdio::abort();
     }
 }
 
@@ -12579,7 +12573,7 @@ pub extern "C" fn blood_assert_eq_int(a: i32, b: i32) {
 pub extern "C" fn blood_assert_eq_i64(a: i64, b: i64) {
     if a != b {
         eprintln!("BLOOD RUNTIME PANIC: assertion failed: {} != {}", a, b);
-        std::process::abort();
+        stdio::abort();
     }
 }
 
@@ -12588,7 +12582,7 @@ pub extern "C" fn blood_assert_eq_i64(a: i64, b: i64) {
 pub extern "C" fn blood_assert_eq_u32(a: u32, b: u32) {
     if a != b {
         eprintln!("BLOOD RUNTIME PANIC: assertion failed: {} != {}", a, b);
-        std::process::abort();
+        stdio::abort();
     }
 }
 
@@ -12597,7 +12591,7 @@ pub extern "C" fn blood_assert_eq_u32(a: u32, b: u32) {
 pub extern "C" fn blood_assert_eq_u64(a: u64, b: u64) {
     if a != b {
         eprintln!("BLOOD RUNTIME PANIC: assertion failed: {} != {}", a, b);
-        std::process::abort();
+        stdio::abort();
     }
 }
 
@@ -12606,7 +12600,7 @@ pub extern "C" fn blood_assert_eq_u64(a: u64, b: u64) {
 pub extern "C" fn blood_assert_eq_usize(a: u64, b: u64) {
     if a != b {
         eprintln!("BLOOD RUNTIME PANIC: assertion failed: {} != {}", a, b);
-        std::process::abort();
+        stdio::abort();
     }
 }
 
@@ -12631,7 +12625,7 @@ pub unsafe extern "C" fn blood_assert_eq_str(a: BloodStr, b: BloodStr) {
             "BLOOD RUNTIME PANIC: assertion failed: \"{}\" != \"{}\"",
             a_str, b_str
         );
-        std::process::abort();
+        stdio::abort();
     }
 }
 
@@ -12643,7 +12637,7 @@ pub extern "C" fn blood_assert_ne_int(a: i32, b: i32) {
             "BLOOD RUNTIME PANIC: assertion failed: {} == {} (expected not equal)",
             a, b
         );
-        std::process::abort();
+        stdio::abort();
     }
 }
 
@@ -12743,7 +12737,14 @@ pub extern "C" fn blood_float64_to_bits(value: f64) -> u64 {
 pub unsafe extern "C" fn blood_thread_spawn(func_ptr: u64, arg: u64) -> u64 {
     let f: extern "C" fn(u64) -> u64 = std::mem::transmute(func_ptr);
 
-    match std::thread::Builder::new().spawn(move || f(arg)) {
+    // Flush at spawn and completion so output keeps program order.
+    stdio::flush_stdout();
+    let body = move || {
+        let result = f(arg);
+        stdio::flush_stdout();
+        result
+    };
+    match std::thread::Builder::new().spawn(body) {
         Ok(handle) => Box::into_raw(Box::new(handle)) as u64,
         Err(_) => 0,
     }
@@ -12764,6 +12765,7 @@ pub unsafe extern "C" fn blood_thread_join(handle: u64) -> u64 {
     }
     let boxed: Box<std::thread::JoinHandle<u64>> =
         Box::from_raw(handle as *mut std::thread::JoinHandle<u64>);
+    stdio::flush_stdout();
     match boxed.join() {
         Ok(_) => 0,
         Err(_) => 1,
@@ -12806,8 +12808,10 @@ pub unsafe extern "C" fn __builtin_fiber_spawn(fn_ptr: u64) -> u64 {
     let fiber_id = BUILTIN_FIBER_NEXT_ID.fetch_add(1, std::sync::atomic::Ordering::SeqCst);
     let f: extern "C" fn() -> u64 = std::mem::transmute(fn_ptr);
 
+    stdio::flush_stdout();
     let handle = std::thread::spawn(move || {
         let result = f();
+        stdio::flush_stdout();
         FIBER_RESULTS.lock().unwrap().insert(fiber_id, result);
         result
     });
@@ -12828,6 +12832,7 @@ pub unsafe extern "C" fn __builtin_fiber_spawn_with(config_ptr: u64, fn_ptr: u64
 /// Returns the fiber's result value, or 0 if not found.
 #[no_mangle]
 pub extern "C" fn __builtin_fiber_join(fiber_id: u64) -> u64 {
+    stdio::flush_stdout();
     // Take the thread handle (if it exists) and join it
     let handle = FIBER_THREADS.lock().unwrap().remove(&fiber_id);
     if let Some(h) = handle {
@@ -12862,6 +12867,7 @@ pub extern "C" fn __builtin_fiber_sleep(nanos: u64) {
 /// Park the current fiber until unparked.
 #[no_mangle]
 pub extern "C" fn __builtin_fiber_park() {
+    stdio::flush_stdout();
     std::thread::park();
 }
 
@@ -18,6 +18,7 @@ use std::fmt;
 use std::sync::atomic::{AtomicU64, Ordering};
 
 use crate::cancellation::{CancellationError, CancellationSource, CancellationToken};
+use crate::fiber_local::{FiberContext as LocalContext, FiberLocalStorage};
 
 /// Unique identifier for a fiber.
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
@@ -329,6 +330,8 @@ pub struct Fiber {
     cancellation_source: CancellationSource,
     /// Cancellation token for checking cancellation state.
     cancellation_token: CancellationToken,
+    /// Fiber-local storage, installed on the worker thread while the fiber runs.
+    local_storage: FiberLocalStorage,
 }
 
 impl Fiber {
@@ -358,6 +361,7 @@ impl Fiber {
             result: None,
             cancellation_source,
             cancellation_token,
+            local_storage: LocalContext::inherited(),
         }
     }
 
@@ -371,6 +375,12 @@ impl Fiber {
         fiber
     }
 
+    /// Replace the fiber's local storage, e.g. with storage inherited from
+    /// the fiber that parked it.
+    pub(crate) fn set_local_storage(&mut self, storage: FiberLocalStorage) {
+        self.local_storage = storage;
+    }
+
     /// Check if the fiber is runnable.
     pub fn is_runnable(&self) -> bool {
         self.state == FiberState::Runnable
@@ -462,7 +472,13 @@ impl Fiber {
 
         if let Some(task) = self.task.take() {
             self.state = FiberState::Running;
+            // Context switch: install this fiber's locals for the duration
+            // of the task so lookups need no per-call swapping.
+            let outer = LocalContext::swap(Some(std::mem::take(&mut self.local_storage)));
             task();
+            // Flush before the worker picks up another fiber.
+            crate::stdio::flush_stdout();
+            self.local_storage = LocalContext::swap(outer).unwrap_or_default();
             // Check if task completed normally or was interrupted
             if self.state == FiberState::Running {
                 // Check for cancellation that may have occurred during execution
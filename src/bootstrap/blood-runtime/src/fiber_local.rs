@@ -35,17 +35,30 @@ use std::any::Any;
 use std::cell::RefCell;
 use std::collections::HashMap;
 use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::Arc;
+
+/// Next key to hand out. Key 0 is reserved for "not yet registered".
+static NEXT_KEY: AtomicU64 = AtomicU64::new(1);
 
 /// Unique key for a fiber-local variable.
+///
+/// Keys are allocated densely at registration time, so each key doubles
+/// as an index into the per-fiber slot vectors.
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
 pub struct FiberLocalKey(u64);
 
 impl FiberLocalKey {
     /// Generate a new unique key.
     pub fn new() -> Self {
-        static NEXT_KEY: AtomicU64 = AtomicU64::new(1);
         Self(NEXT_KEY.fetch_add(1, Ordering::Relaxed))
     }
+
+    /// Slot index of this key in fiber-local storage.
+    #[inline]
+    fn index(self) -> usize {
+        debug_assert!(self.0 != 0, "unregistered fiber-local key");
+        (self.0 - 1) as usize
+    }
 }
 
 impl Default for FiberLocalKey {
@@ -54,73 +67,135 @@ impl Default for FiberLocalKey {
     }
 }
 
+/// A value shared between a fiber and the children it spawned.
+type SharedValue = Arc<dyn Any + Send + Sync>;
+
 /// Storage for fiber-local values.
 ///
 /// This is stored per-fiber and contains all fiber-local values for that fiber.
+/// Values live in two slot vectors indexed by key:
+///
+/// - `slots` holds values private to this fiber, as set by [`set`](Self::set).
+/// - `propagated` holds values inherited by child fibers. The vector is shared
+///   copy-on-write between parent and children, so spawning a child clones a
+///   single `Arc`; the first write after sharing copies only the pointer
+///   vector, never the values themselves.
 #[derive(Debug, Default)]
 pub struct FiberLocalStorage {
-    /// Map from key to boxed value.
-    values: HashMap<FiberLocalKey, Box<dyn Any + Send>>,
+    /// Fiber-private values, indexed by key.
+    slots: Vec<Option<Box<dyn Any + Send>>>,
+    /// Inheritable values, shared copy-on-write with related fibers.
+    propagated: Arc<Vec<Option<SharedValue>>>,
 }
 
 impl FiberLocalStorage {
     /// Create new empty storage.
     pub fn new() -> Self {
         Self {
-            values: HashMap::new(),
+            slots: Vec::new(),
+            propagated: Arc::new(Vec::new()),
         }
     }
 
     /// Get a value by key.
+    ///
+    /// Fiber-private values shadow propagated ones.
     pub fn get<T: 'static + Send>(&self, key: FiberLocalKey) -> Option<&T> {
-        self.values.get(&key)?.downcast_ref::<T>()
+        let index = key.index();
+        if let Some(Some(value)) = self.slots.get(index) {
+            return value.downcast_ref::<T>();
+        }
+        self.propagated.get(index)?.as_ref()?.downcast_ref::<T>()
     }
 
     /// Get a mutable value by key.
+    ///
+    /// Only fiber-private values are mutable in place; propagated values are
+    /// shared with other fibers and must be replaced with
+    /// [`set_propagated`](Self::set_propagated).
     pub fn get_mut<T: 'static + Send>(&mut self, key: FiberLocalKey) -> Option<&mut T> {
-        self.values.get_mut(&key)?.downcast_mut::<T>()
+        self.slots.get_mut(key.index())?.as_mut()?.downcast_mut::<T>()
     }
 
-    /// Set a value by key.
+    /// Set a fiber-private value by key.
     pub fn set<T: 'static + Send>(&mut self, key: FiberLocalKey, value: T) {
-        self.values.insert(key, Box::new(value));
+        let index = key.index();
+        if index >= self.slots.len() {
+            self.slots.resize_with(index + 1, || None);
+        }
+        self.slots[index] = Some(Box::new(value));
+    }
+
+    /// Set a value that child fibers spawned from now on will inherit.
+    pub fn set_propagated<T: 'static + Send + Sync>(&mut self, key: FiberLocalKey, value: T) {
+        let index = key.index();
+        if let Some(slot) = self.slots.get_mut(index) {
+            *slot = None;
+        }
+        let propagated = Arc::make_mut(&mut self.propagated);
+        if index >= propagated.len() {
+            propagated.resize(index + 1, None);
+        }
+        propagated[index] = Some(Arc::new(value));
     }
 
     /// Remove a value by key.
     pub fn remove(&mut self, key: FiberLocalKey) -> bool {
-        self.values.remove(&key).is_some()
+        let index = key.index();
+        let mut removed = false;
+        if let Some(slot) = self.slots.get_mut(index) {
+            removed = slot.take().is_some();
+        }
+        if matches!(self.propagated.get(index), Some(Some(_))) {
+            Arc::make_mut(&mut self.propagated)[index] = None;
+            removed = true;
+        }
+        removed
     }
 
     /// Check if a key exists.
     pub fn contains(&self, key: FiberLocalKey) -> bool {
-        self.values.contains_key(&key)
+        let index = key.index();
+        matches!(self.slots.get(index), Some(Some(_)))
+            || matches!(self.propagated.get(index), Some(Some(_)))
     }
 
     /// Clear all values.
     pub fn clear(&mut self) {
-        self.values.clear();
+        self.slots.clear();
+        self.propagated = Arc::new(Vec::new());
     }
 
-    /// Clone values that implement Clone (for propagation to child fibers).
+    /// Create storage for a child fiber.
     ///
-    /// This creates a new storage with cloned values for types that implement Clone.
-    /// Values that don't implement Clone are not propagated.
+    /// The child sees every propagated value of this fiber and none of its
+    /// private ones. This is O(1): the propagated slots are shared, not copied.
     pub fn clone_propagated(&self) -> Self {
-        // For now, we can't easily clone arbitrary boxed values.
-        // In production, we'd use a registration system where types
-        // explicitly opt into propagation.
-        Self::new()
+        Self {
+            slots: Vec::new(),
+            propagated: Arc::clone(&self.propagated),
+        }
     }
 
     /// Merge another storage into this one (for context inheritance).
+    ///
+    /// Propagated values of `other` fill keys this storage does not already
+    /// hold; the values themselves are shared, not cloned.
     pub fn merge_from(&mut self, other: &FiberLocalStorage) {
-        // For types we can clone, copy them over.
-        // This is a simplified implementation.
-        for (&key, _value) in &other.values {
-            if !self.values.contains_key(&key) {
-                // In a full implementation, we'd clone the value if possible
-                // For now, skip non-cloneable values
+        if Arc::ptr_eq(&self.propagated, &other.propagated) {
+            return;
+        }
+        for (index, value) in other.propagated.iter().enumerate() {
+            let Some(value) = value else { continue };
+            let key = FiberLocalKey(index as u64 + 1);
+            if self.contains(key) {
+                continue;
             }
+            let propagated = Arc::make_mut(&mut self.propagated);
+            if index >= propagated.len() {
+                propagated.resize(index + 1, None);
+            }
+            propagated[index] = Some(Arc::clone(value));
         }
     }
 }
@@ -130,9 +205,9 @@ impl FiberLocalStorage {
 /// This provides access to a value that is unique to each fiber.
 /// The value is lazily initialized on first access.
 pub struct FiberLocal<T> {
-    /// The unique key for this variable.
+    /// The key for this variable; 0 until first use.
     #[allow(dead_code)]
-    key: FiberLocalKey,
+    key: AtomicU64,
     /// Default value initializer.
     #[allow(dead_code)]
     init: fn() -> T,
@@ -144,24 +219,33 @@ impl<T: 'static + Send> FiberLocal<T> {
     /// Create a new fiber-local variable with a default initializer.
     pub const fn new(init: fn() -> T) -> Self {
         Self {
-            key: FiberLocalKey(0), // Will be assigned at runtime
+            key: AtomicU64::new(0), // Assigned on first use
             init,
             _marker: std::marker::PhantomData,
         }
     }
 
-    /// Get the key for this variable, initializing it if needed.
+    /// Get the key for this variable, registering it on first use.
     #[allow(dead_code)]
     fn get_key(&self) -> FiberLocalKey {
-        // In a real implementation, we'd use lazy initialization.
-        // For now, generate a new key based on the address of self.
-        let ptr = self as *const _ as u64;
-        FiberLocalKey(ptr)
+        let key = self.key.load(Ordering::Acquire);
+        if key != 0 {
+            return FiberLocalKey(key);
+        }
+        let fresh = FiberLocalKey::new();
+        match self
+            .key
+            .compare_exchange(0, fresh.0, Ordering::AcqRel, Ordering::Acquire)
+        {
+            Ok(_) => fresh,
+            Err(winner) => FiberLocalKey(winner),
+        }
     }
 }
 
-// Thread-local storage for the current fiber's local storage.
-// This is used when we don't have access to the fiber directly.
+// Thread-local storage for the running fiber's local storage.
+// The scheduler installs a fiber's storage here when it switches to the
+// fiber and takes it back when the fiber yields or completes.
 thread_local! {
     static CURRENT_FIBER_STORAGE: RefCell<Option<FiberLocalStorage>> = RefCell::new(None);
 }
@@ -173,19 +257,34 @@ thread_local! {
 pub struct FiberContext;
 
 impl FiberContext {
+    /// Install `storage` as the current fiber's storage, returning the
+    /// previously installed one. Called on every fiber context switch.
+    pub fn swap(storage: Option<FiberLocalStorage>) -> Option<FiberLocalStorage> {
+        CURRENT_FIBER_STORAGE.with(|cell| std::mem::replace(&mut *cell.borrow_mut(), storage))
+    }
+
     /// Run code with fiber-local storage available.
-    pub fn with_storage<F, R>(_storage: &mut FiberLocalStorage, f: F) -> R
+    ///
+    /// Changes made by `f` are written back to `storage`.
+    pub fn with_storage<F, R>(storage: &mut FiberLocalStorage, f: F) -> R
     where
         F: FnOnce() -> R,
     {
-        // Save the current storage and install the new one
+        let old = Self::swap(Some(std::mem::take(storage)));
+        let result = f();
+        *storage = Self::swap(old).unwrap_or_default();
+        result
+    }
+
+    /// Storage for a fiber spawned from the current context.
+    ///
+    /// Inherits the current fiber's propagated values in O(1).
+    pub fn inherited() -> FiberLocalStorage {
         CURRENT_FIBER_STORAGE.with(|cell| {
-            let old = cell.borrow_mut().take();
-            // Note: This is a simplified implementation.
-            // In production, we'd properly swap the storage.
-            let result = f();
-            *cell.borrow_mut() = old;
-            result
+            cell.borrow()
+                .as_ref()
+                .map(FiberLocalStorage::clone_propagated)
+                .unwrap_or_default()
         })
     }
 
@@ -207,6 +306,15 @@ impl FiberContext {
         });
     }
 
+    /// Set a value in the current fiber's storage that child fibers inherit.
+    pub fn set_propagated<T: 'static + Send + Sync>(key: FiberLocalKey, value: T) {
+        CURRENT_FIBER_STORAGE.with(|cell| {
+            if let Some(storage) = cell.borrow_mut().as_mut() {
+                storage.set_propagated(key, value);
+            }
+        });
+    }
+
     /// Initialize fiber-local storage for the current context.
     pub fn init_storage() {
         CURRENT_FIBER_STORAGE.with(|cell| {
@@ -246,7 +354,7 @@ pub struct PropagatedLocal<T> {
     _marker: std::marker::PhantomData<T>,
 }
 
-impl<T: 'static + Send + Clone> PropagatedLocal<T> {
+impl<T: 'static + Send + Sync + Clone> PropagatedLocal<T> {
     /// Create a new propagated local with copy semantics.
     pub fn new_copied() -> Self {
         Self {
@@ -261,9 +369,9 @@ impl<T: 'static + Send + Clone> PropagatedLocal<T> {
         FiberContext::get(self.key)
     }
 
-    /// Set the current value.
+    /// Set the current value. Fibers spawned afterwards inherit it.
     pub fn set(&self, value: T) {
-        FiberContext::set(self.key, value);
+        FiberContext::set_propagated(self.key, value);
     }
 
     /// Get the propagation mode.
@@ -488,6 +596,45 @@ mod tests {
         assert!(!storage.contains(key));
     }
 
+    #[test]
+    fn test_propagated_storage_is_copy_on_write() {
+        let mut parent = FiberLocalStorage::new();
+        let shared = FiberLocalKey::new();
+        let private = FiberLocalKey::new();
+        parent.set_propagated(shared, 7u64);
+        parent.set(private, 1u64);
+
+        // Children see propagated values only.
+        let mut child = parent.clone_propagated();
+        assert_eq!(child.get::<u64>(shared), Some(&7));
+        assert!(!child.contains(private));
+
+        // Writes after the split are not visible across it.
+        child.set_propagated(shared, 8u64);
+        assert_eq!(parent.get::<u64>(shared), Some(&7));
+        assert_eq!(child.get::<u64>(shared), Some(&8));
+
+        // Private values shadow propagated ones.
+        parent.set(shared, 9u64);
+        assert_eq!(parent.get::<u64>(shared), Some(&9));
+        assert!(parent.remove(shared));
+        assert!(!parent.contains(shared));
+    }
+
+    #[test]
+    fn test_fiber_context_inherits_propagated() {
+        let trace = PropagatedLocal::<TraceContext>::new_copied();
+        let root = TraceContext::new_root();
+        let mut storage = FiberLocalStorage::new();
+        let child = FiberContext::with_storage(&mut storage, || {
+            trace.set(root.clone());
+            FiberContext::inherited()
+        });
+        assert_eq!(storage.get::<TraceContext>(trace.key), Some(&root));
+        assert_eq!(child.get::<TraceContext>(trace.key), Some(&root));
+        assert!(FiberContext::inherited().get::<TraceContext>(trace.key).is_none());
+    }
+
     #[test]
     fn test_trace_context() {
         let root = TraceContext::new_root();
@@ -368,8 +368,13 @@ pub struct IoReactor {
     fiber_mappings: Mutex<HashMap<IoOpId, FiberId>>,
     /// Completed operations waiting to be collected.
     completed: Mutex<HashMap<IoOpId, IoResult>>,
+    /// Continuations to run when their operation completes.
+    continuations: Mutex<HashMap<IoOpId, IoContinuation>>,
 }
 
+/// Continuation run by [`IoReactor::dispatch`] when its operation completes.
+pub type IoContinuation = Box<dyn FnOnce(IoResult) + Send>;
+
 impl IoReactor {
     /// Create a new I/O reactor with the default driver.
     pub fn new(config: ReactorConfig) -> Self {
@@ -379,6 +384,7 @@ impl IoReactor {
             pending_count: AtomicU64::new(0),
             fiber_mappings: Mutex::new(HashMap::new()),
             completed: Mutex::new(HashMap::new()),
+            continuations: Mutex::new(HashMap::new()),
         }
     }
 
@@ -390,6 +396,7 @@ impl IoReactor {
             pending_count: AtomicU64::new(0),
             fiber_mappings: Mutex::new(HashMap::new()),
             completed: Mutex::new(HashMap::new()),
+            continuations: Mutex::new(HashMap::new()),
         }
     }
 
@@ -410,6 +417,54 @@ impl IoReactor {
         Ok(op_id)
     }
 
+    /// Submit an operation and run `k` with its result when it completes.
+    ///
+    /// `k` runs on whichever thread calls [`dispatch`](Self::dispatch), so a
+    /// fiber waiting on the operation parks as a closure instead of holding
+    /// a worker thread.
+    pub fn submit_with<F>(&self, op: IoOp, k: F) -> io::Result<IoOpId>
+    where
+        F: FnOnce(IoResult) + Send + 'static,
+    {
+        let op_id = next_io_op_id();
+        // Register first: the driver may complete the op before submit returns.
+        self.continuations.lock().insert(op_id, Box::new(k));
+        if let Err(e) = self.driver.submit(op_id, op) {
+            self.continuations.lock().remove(&op_id);
+            return Err(e);
+        }
+        self.pending_count.fetch_add(1, Ordering::Relaxed);
+        Ok(op_id)
+    }
+
+    /// Poll for up to `timeout` and run the continuations of completed
+    /// operations. Completions without a continuation are stored for
+    /// [`try_get_result`](Self::try_get_result). Returns the number of
+    /// continuations run.
+    pub fn dispatch(&self, timeout: Duration) -> io::Result<usize> {
+        let completions = self.poll_timeout(timeout)?;
+        let mut ready = Vec::with_capacity(completions.len());
+        {
+            let mut continuations = self.continuations.lock();
+            for completion in completions {
+                match continuations.remove(&completion.op_id) {
+                    Some(k) => ready.push((k, completion.result)),
+                    None => self.store_completion(completion.op_id, completion.result),
+                }
+            }
+        }
+        let count = ready.len();
+        for (k, result) in ready {
+            k(result);
+        }
+        Ok(count)
+    }
+
+    /// Number of continuations waiting for their operation to complete.
+    pub fn continuation_count(&self) -> usize {
+        self.continuations.lock().len()
+    }
+
     /// Poll for completed operations.
     pub fn poll(&self) -> io::Result<Vec<IoCompletion>> {
         let completions = self.driver.poll(self.config.poll_timeout)?;
@@ -442,6 +497,7 @@ impl IoReactor {
         self.driver.cancel(op_id)?;
         self.pending_count.fetch_sub(1, Ordering::Relaxed);
         self.fiber_mappings.lock().remove(&op_id);
+        self.continuations.lock().remove(&op_id);
         Ok(())
     }
 
@@ -1482,6 +1538,7 @@ pub mod linux {
                 read_buf: None,
                 timer_fd: None,
             };
+            let mut pending = self.pending.lock();
 
             match &op {
                 IoOp::Read { fd, buf_len, .. } => {
@@ -1537,7 +1594,9 @@ pub mod linux {
                 }
             }
 
-            self.pending.lock().insert(op_id, pending_op);
+            // Still holding the lock: a concurrent poll() that sees the
+            // event blocks here instead of dropping an unknown op_id.
+            pending.insert(op_id, pending_op);
             Ok(())
         }
 
@@ -2760,6 +2819,55 @@ pub fn create_native_reactor(config: ReactorConfig) -> IoReactor {
     IoReactor::with_driver(config, create_native_driver())
 }
 
+// ============================================================================
+// Runtime event loop
+// ============================================================================
+
+/// The runtime-wide reactor driven by the scheduler's event loop.
+static GLOBAL_REACTOR: std::sync::OnceLock<IoReactor> = std::sync::OnceLock::new();
+
+/// Whether the signal self-pipe currently has a poll armed on the global reactor.
+static SIGNAL_POLL_ARMED: std::sync::atomic::AtomicBool = std::sync::atomic::AtomicBool::new(false);
+
+/// Get the runtime-wide reactor, creating it with the native driver.
+pub fn global_reactor() -> &'static IoReactor {
+    GLOBAL_REACTOR.get_or_init(|| create_native_reactor(ReactorConfig::from_runtime_config()))
+}
+
+/// Run one iteration of the runtime event loop.
+///
+/// Waits up to `timeout` on the global reactor, which also watches the
+/// signal self-pipe, then runs every continuation whose I/O or signal is
+/// ready. Returns the number of continuations run.
+pub fn poll_events(timeout: Duration) -> usize {
+    let reactor = global_reactor();
+    if let Some(fd) = crate::signal::signal_fd() {
+        if !SIGNAL_POLL_ARMED.swap(true, Ordering::AcqRel) {
+            let armed = reactor.submit_with(
+                IoOp::Poll {
+                    fd,
+                    interest: Interest::READABLE,
+                },
+                |_| SIGNAL_POLL_ARMED.store(false, Ordering::Release),
+            );
+            if armed.is_err() {
+                SIGNAL_POLL_ARMED.store(false, Ordering::Release);
+            }
+        }
+    }
+    let woken = reactor.dispatch(timeout).unwrap_or(0);
+    woken + crate::signal::dispatch_pending()
+}
+
+/// Number of continuations parked on I/O in the global reactor.
+pub fn parked_count() -> usize {
+    let Some(reactor) = GLOBAL_REACTOR.get() else {
+        return 0;
+    };
+    let internal = SIGNAL_POLL_ARMED.load(Ordering::Acquire) as usize;
+    reactor.continuation_count().saturating_sub(internal)
+}
+
 // ============================================================================
 // Tests
 // ============================================================================
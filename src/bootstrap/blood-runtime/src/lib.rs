@@ -63,6 +63,7 @@ pub mod scheduler;
 pub mod serialize;
 pub mod signal;
 pub mod simd;
+pub mod stdio;
 pub mod stdlib;
 pub mod sync;
 pub mod timeout;
@@ -80,7 +81,7 @@ pub use fiber_local::{
 };
 pub use panic::{BloodPanicInfo, Location as PanicLocation};
 pub use scheduler::{Scheduler, Worker};
-pub use signal::{Signal, SignalHandler};
+pub use signal::{Signal, SignalHandler, SignalSet};
 pub use sync::{Barrier, Mutex, Once, OnceLock, RwLock, Semaphore};
 pub use timeout::{
     with_timeout, with_timeout_and_parent, Deadline, Timeout, TimeoutBuilder, TimeoutError,
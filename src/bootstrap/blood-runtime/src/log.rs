@@ -31,11 +31,12 @@
 //! ```
 
 use std::fmt;
-use std::io::Write;
 use std::sync::atomic::{AtomicBool, AtomicU8, Ordering};
 use std::sync::{Mutex, OnceLock};
 use std::time::{SystemTime, UNIX_EPOCH};
 
+use crate::stdio;
+
 /// Log level enumeration.
 #[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Hash)]
 #[repr(u8)]
@@ -448,16 +449,18 @@ pub fn emit(entry: &LogEntry) {
         entry.format(config.format)
     };
 
-    // Write to output
-    let config = match get_logger().lock() {
-        Ok(c) => c,
+    // Write to output. Both paths go through the runtime's stdout buffer:
+    // stdout entries are appended to it, and stderr entries flush it first,
+    // so log lines stay in order with the program's own output.
+    let use_stderr = match get_logger().lock() {
+        Ok(c) => c.use_stderr,
         Err(_) => return,
     };
 
-    if config.use_stderr {
-        let _ = writeln!(std::io::stderr(), "{}", output);
+    if use_stderr {
+        stdio::eprint_bytes(output.as_bytes(), true);
     } else {
-        let _ = writeln!(std::io::stdout(), "{}", output);
+        stdio::println_bytes(output.as_bytes());
     }
 }
 
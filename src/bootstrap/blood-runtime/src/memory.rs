@@ -31,6 +31,8 @@ use std::fmt;
 use std::sync::atomic::{AtomicU32, AtomicU64, AtomicUsize, Ordering};
 use std::sync::OnceLock;
 
+use crate::stdio::eprintln;
+
 #[cfg(unix)]
 use nix::libc;
 
@@ -31,6 +31,8 @@ use std::panic::PanicHookInfo;
 use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
 use std::sync::{Arc, Mutex, OnceLock};
 
+use crate::stdio::eprintln;
+
 /// Counter for panic events.
 static PANIC_COUNT: AtomicU64 = AtomicU64::new(0);
 
@@ -212,7 +214,8 @@ fn handle_panic(info: &PanicHookInfo<'_>) {
         }
     }
 
-    // Also print to stderr if no hooks are registered or as fallback
+    // Also print to stderr if no hooks are registered or as fallback,
+    // after any output this thread still has buffered.
     eprintln!("{}", panic_info.format());
 }
 
@@ -10,6 +10,9 @@
 //! - **Environment**: Set environment variables for child processes
 //! - **Working Directory**: Set the working directory for child processes
 //! - **Exit Status**: Wait for and retrieve exit codes
+//! - **Non-blocking Waits** (Unix): `wait_async`, `output_async` and
+//!   `lines_async` park the caller as a continuation on the runtime's I/O
+//!   poller instead of blocking a scheduler worker
 //!
 //! # Example
 //!
@@ -35,7 +38,19 @@
 //!     .spawn()?;
 //!
 //! let status = child.wait()?;
+//!
+//! // From a fiber: collect output without blocking the worker
+//! Command::new("cc")
+//!     .args(&["-c", "bar.c"])
+//!     .output_async(scheduler.resume_in_fiber(|output| report(output)));
 //! ```
+//!
+//! # Spawning
+//!
+//! Children are created through `std::process`, which uses `posix_spawn`
+//! (vfork semantics) on Linux whenever the configuration allows. On Linux
+//! the exit of an asynchronously awaited child is watched through a pidfd;
+//! elsewhere, and on kernels without `pidfd_open`, through SIGCHLD.
 
 use std::collections::HashMap;
 use std::ffi::{OsStr, OsString};
@@ -45,6 +60,17 @@ use std::process::{self, ExitStatus, Stdio as StdStdio};
 use std::sync::atomic::{AtomicU64, Ordering};
 use std::time::Duration;
 
+#[cfg(unix)]
+use crate::io::{global_reactor, Interest, IoOp};
+#[cfg(unix)]
+use crate::signal::{self, Signal, SignalSet};
+#[cfg(unix)]
+use parking_lot::Mutex;
+#[cfg(unix)]
+use std::os::unix::io::{AsRawFd, RawFd};
+#[cfg(unix)]
+use std::sync::Arc;
+
 /// Get the configured compute timeout from the runtime configuration.
 ///
 /// Returns the default (30 seconds) if no runtime config is available.
@@ -258,6 +284,31 @@ impl Command {
             stderr: output.stderr,
         })
     }
+
+    /// Execute the command and collect its output without blocking.
+    ///
+    /// Like [`output`](Self::output), stdout and stderr are captured unless
+    /// configured otherwise and stdin defaults to null. `k` runs once the
+    /// child has exited and both pipes are drained.
+    #[cfg(unix)]
+    pub fn output_async<F>(&mut self, k: F)
+    where
+        F: FnOnce(io::Result<Output>) + Send + 'static,
+    {
+        let mut cmd = self.to_std_command();
+        cmd.stdin(self.stdin.unwrap_or(Stdio::Null).to_std());
+        cmd.stdout(self.stdout.unwrap_or(Stdio::Piped).to_std());
+        cmd.stderr(self.stderr.unwrap_or(Stdio::Piped).to_std());
+        match cmd.spawn() {
+            Ok(child) => Child {
+                id: PROCESS_ID_COUNTER.fetch_add(1, Ordering::SeqCst),
+                inner: child,
+                program: self.program.clone(),
+            }
+            .output_async(k),
+            Err(e) => k(Err(e)),
+        }
+    }
 }
 
 /// Describes what to do with a standard I/O stream.
@@ -413,6 +464,106 @@ impl Child {
     pub fn wait_with_configured_timeout_or_kill(&mut self) -> io::Result<ProcessStatus> {
         self.wait_timeout_or_kill(configured_compute_timeout())
     }
+
+    /// Reap the child without blocking, running `k` once it has exited.
+    ///
+    /// If the child is still running, `k` is parked on SIGCHLD (see
+    /// [`signal::await_signal`]) and re-checked on each delivery, so no
+    /// thread waits on the child. SIGCHLD deliveries coalesce and may be
+    /// for other children, hence the re-check.
+    #[cfg(unix)]
+    pub fn on_exit<F>(mut self, k: F)
+    where
+        F: FnOnce(io::Result<ProcessStatus>) + Send + 'static,
+    {
+        signal::install_handlers();
+        let set = SignalSet::of(Signal::Chld);
+        let epoch = signal::dispatch_epoch(set);
+        match self.try_wait() {
+            Ok(Some(status)) => k(Ok(status)),
+            Err(e) => k(Err(e)),
+            Ok(None) => signal::await_signal_after(set, epoch, move |_| self.on_exit(k)),
+        }
+    }
+
+    /// Wait for the child to exit without blocking, then run `k`.
+    ///
+    /// On Linux the child's pidfd is registered with the runtime's I/O
+    /// poller; otherwise this falls back to [`on_exit`](Self::on_exit).
+    #[cfg(unix)]
+    pub fn wait_async<F>(self, k: F)
+    where
+        F: FnOnce(io::Result<ProcessStatus>) + Send + 'static,
+    {
+        #[cfg(target_os = "linux")]
+        if let Some(pidfd) = pidfd_open(self.pid()) {
+            let fd = pidfd.as_raw_fd();
+            park_readable(
+                fd,
+                (self, k, pidfd),
+                |(mut child, k, _pidfd)| {
+                    // The pidfd is readable once the child is a zombie, so
+                    // this reaps without blocking.
+                    k(child.try_wait().and_then(|status| {
+                        status.ok_or_else(|| io::Error::other("pidfd ready but child still running"))
+                    }))
+                },
+                |(child, k, _pidfd), _err| child.on_exit(k),
+            );
+            return;
+        }
+        self.on_exit(k)
+    }
+
+    /// Collect the child's remaining output and exit status without
+    /// blocking, then run `k`.
+    ///
+    /// Streams that were not piped are reported as empty.
+    #[cfg(unix)]
+    pub fn output_async<F>(mut self, k: F)
+    where
+        F: FnOnce(io::Result<Output>) + Send + 'static,
+    {
+        let collector = Arc::new(Mutex::new(OutputCollector {
+            output: Output {
+                status: ProcessStatus::from_code(-1),
+                stdout: Vec::new(),
+                stderr: Vec::new(),
+            },
+            error: None,
+            remaining: 3,
+            k: Some(Box::new(k)),
+        }));
+
+        match self.stdout() {
+            Some(stdout) => {
+                let sink = collector.clone();
+                let finish = collector.clone();
+                read_async(
+                    stdout,
+                    move |chunk| sink.lock().output.stdout.extend_from_slice(chunk),
+                    move |result| OutputCollector::finish(&finish, result),
+                );
+            }
+            None => OutputCollector::finish(&collector, Ok(())),
+        }
+        match self.stderr() {
+            Some(stderr) => {
+                let sink = collector.clone();
+                let finish = collector.clone();
+                read_async(
+                    stderr,
+                    move |chunk| sink.lock().output.stderr.extend_from_slice(chunk),
+                    move |result| OutputCollector::finish(&finish, result),
+                );
+            }
+            None => OutputCollector::finish(&collector, Ok(())),
+        }
+        self.wait_async(move |result| {
+            let result = result.map(|status| collector.lock().output.status = status);
+            OutputCollector::finish(&collector, result);
+        });
+    }
 }
 
 /// Handle to a child process's stdin.
@@ -443,6 +594,28 @@ impl Read for ChildStdout {
     }
 }
 
+#[cfg(unix)]
+impl AsRawFd for ChildStdout {
+    fn as_raw_fd(&self) -> RawFd {
+        self.inner.as_raw_fd()
+    }
+}
+
+#[cfg(unix)]
+impl ChildStdout {
+    /// Stream the child's stdout line by line without blocking.
+    ///
+    /// `on_line` receives each line without its trailing newline; `done`
+    /// runs at end of stream or on the first read error.
+    pub fn lines_async<L, F>(self, on_line: L, done: F)
+    where
+        L: FnMut(String) + Send + 'static,
+        F: FnOnce(io::Result<()>) + Send + 'static,
+    {
+        lines_async(self, on_line, done)
+    }
+}
+
 /// Handle to a child process's stderr.
 #[derive(Debug)]
 pub struct ChildStderr {
@@ -455,6 +628,27 @@ impl Read for ChildStderr {
     }
 }
 
+#[cfg(unix)]
+impl AsRawFd for ChildStderr {
+    fn as_raw_fd(&self) -> RawFd {
+        self.inner.as_raw_fd()
+    }
+}
+
+#[cfg(unix)]
+impl ChildStderr {
+    /// Stream the child's stderr line by line without blocking.
+    ///
+    /// See [`ChildStdout::lines_async`].
+    pub fn lines_async<L, F>(self, on_line: L, done: F)
+    where
+        L: FnMut(String) + Send + 'static,
+        F: FnOnce(io::Result<()>) + Send + 'static,
+    {
+        lines_async(self, on_line, done)
+    }
+}
+
 /// The status of a completed process.
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
 pub struct ProcessStatus {
@@ -608,6 +802,197 @@ pub enum ProcessErrorKind {
     Other,
 }
 
+// ============================================================================
+// Non-blocking Plumbing
+// ============================================================================
+
+/// Accumulates the three parts of an asynchronous `output` call.
+#[cfg(unix)]
+struct OutputCollector {
+    output: Output,
+    error: Option<io::Error>,
+    /// Parts still outstanding: stdout EOF, stderr EOF, exit status.
+    remaining: u32,
+    k: Option<Box<dyn FnOnce(io::Result<Output>) + Send>>,
+}
+
+#[cfg(unix)]
+impl OutputCollector {
+    /// Record one finished part, running the continuation after the last.
+    fn finish(this: &Mutex<OutputCollector>, result: io::Result<()>) {
+        let ready = {
+            let mut c = this.lock();
+            if let Err(e) = result {
+                c.error.get_or_insert(e);
+            }
+            c.remaining -= 1;
+            if c.remaining > 0 {
+                return;
+            }
+            let output = std::mem::replace(
+                &mut c.output,
+                Output {
+                    status: ProcessStatus::from_code(-1),
+                    stdout: Vec::new(),
+                    stderr: Vec::new(),
+                },
+            );
+            let result = match c.error.take() {
+                Some(e) => Err(e),
+                None => Ok(output),
+            };
+            c.k.take().map(|k| (k, result))
+        };
+        if let Some((k, result)) = ready {
+            k(result);
+        }
+    }
+}
+
+/// Put `fd` into non-blocking mode.
+#[cfg(unix)]
+fn set_nonblocking(fd: RawFd) -> io::Result<()> {
+    // SAFETY: fcntl on a descriptor owned by the caller.
+    let flags = unsafe { libc::fcntl(fd, libc::F_GETFL) };
+    if flags < 0 || unsafe { libc::fcntl(fd, libc::F_SETFL, flags | libc::O_NONBLOCK) } < 0 {
+        return Err(io::Error::last_os_error());
+    }
+    Ok(())
+}
+
+/// Open a pidfd for `pid`; it becomes readable when the process exits.
+///
+/// Returns `None` on kernels older than 5.3.
+#[cfg(target_os = "linux")]
+fn pidfd_open(pid: u32) -> Option<std::os::fd::OwnedFd> {
+    use std::os::fd::FromRawFd;
+    // SAFETY: pidfd_open(pid, 0) returns a new descriptor or -1.
+    let fd = unsafe { libc::syscall(libc::SYS_pidfd_open, pid as libc::pid_t, 0) };
+    if fd < 0 {
+        return None;
+    }
+    // SAFETY: the kernel just handed us this descriptor.
+    Some(unsafe { std::os::fd::OwnedFd::from_raw_fd(fd as RawFd) })
+}
+
+/// Park `state` on the global reactor until `fd` is readable.
+///
+/// `resume` runs from the event loop once it is; `fail` runs immediately
+/// if the poller rejects the descriptor.
+#[cfg(unix)]
+fn park_readable<T: Send + 'static>(fd: RawFd, state: T, resume: fn(T), fail: fn(T, io::Error)) {
+    let slot = Arc::new(Mutex::new(Some(state)));
+    let parked = slot.clone();
+    let submitted = global_reactor().submit_with(
+        IoOp::Poll {
+            fd,
+            interest: Interest::READABLE,
+        },
+        move |_| {
+            let state = parked.lock().take();
+            if let Some(state) = state {
+                resume(state);
+            }
+        },
+    );
+    if let Err(e) = submitted {
+        let state = slot.lock().take();
+        if let Some(state) = state {
+            fail(state, e);
+        }
+    }
+}
+
+/// A pipe being drained by the event loop.
+#[cfg(unix)]
+struct PipeReader<S> {
+    source: S,
+    on_data: Box<dyn FnMut(&[u8]) + Send>,
+    done: Box<dyn FnOnce(io::Result<()>) + Send>,
+}
+
+/// Read `source` to end of stream without blocking, passing each chunk to
+/// `on_data` as it arrives and then running `done`.
+#[cfg(unix)]
+fn read_async<S, D, F>(source: S, on_data: D, done: F)
+where
+    S: AsRawFd + Send + 'static,
+    D: FnMut(&[u8]) + Send + 'static,
+    F: FnOnce(io::Result<()>) + Send + 'static,
+{
+    if let Err(e) = set_nonblocking(source.as_raw_fd()) {
+        return done(Err(e));
+    }
+    pump(PipeReader {
+        source,
+        on_data: Box::new(on_data),
+        done: Box::new(done),
+    });
+}
+
+/// Read everything currently available, then re-park until readable.
+#[cfg(unix)]
+fn pump<S: AsRawFd + Send + 'static>(mut reader: PipeReader<S>) {
+    let fd = reader.source.as_raw_fd();
+    let mut buf = [0u8; 16 * 1024];
+    loop {
+        // SAFETY: reads into a valid stack buffer of the given length.
+        let n = unsafe { libc::read(fd, buf.as_mut_ptr() as *mut libc::c_void, buf.len()) };
+        if n > 0 {
+            (reader.on_data)(&buf[..n as usize]);
+            continue;
+        }
+        if n == 0 {
+            return (reader.done)(Ok(()));
+        }
+        let err = io::Error::last_os_error();
+        match err.kind() {
+            io::ErrorKind::Interrupted => continue,
+            io::ErrorKind::WouldBlock => break,
+            _ => return (reader.done)(Err(err)),
+        }
+    }
+    park_readable(fd, reader, pump::<S>, |reader, err| (reader.done)(Err(err)));
+}
+
+/// Split a stream into lines without blocking.
+#[cfg(unix)]
+fn lines_async<S, L, F>(source: S, on_line: L, done: F)
+where
+    S: AsRawFd + Send + 'static,
+    L: FnMut(String) + Send + 'static,
+    F: FnOnce(io::Result<()>) + Send + 'static,
+{
+    let state = Arc::new(Mutex::new((Vec::<u8>::new(), on_line)));
+    let tail = state.clone();
+    read_async(
+        source,
+        move |chunk| {
+            let mut guard = state.lock();
+            let (partial, on_line) = &mut *guard;
+            let mut rest = chunk;
+            while let Some(pos) = rest.iter().position(|&b| b == b'\n') {
+                partial.extend_from_slice(&rest[..pos]);
+                on_line(String::from_utf8_lossy(partial).into_owned());
+                partial.clear();
+                rest = &rest[pos + 1..];
+            }
+            partial.extend_from_slice(rest);
+        },
+        move |result| {
+            {
+                let mut guard = tail.lock();
+                let (partial, on_line) = &mut *guard;
+                if !partial.is_empty() {
+                    on_line(String::from_utf8_lossy(partial).into_owned());
+                    partial.clear();
+                }
+            }
+            done(result)
+        },
+    );
+}
+
 // ============================================================================
 // Convenience Functions
 // ============================================================================
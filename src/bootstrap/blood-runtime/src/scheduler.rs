@@ -25,7 +25,9 @@ use parking_lot::Mutex;
 
 use crate::cancellation::{CancellationSource, CancellationToken};
 use crate::fiber::{Fiber, FiberConfig, FiberId, FiberState, WakeCondition};
-use crate::signal::{self, SignalHandler};
+use crate::fiber_local::FiberContext;
+use crate::io;
+use crate::signal::{self, Signal, SignalHandler, SignalSet};
 use crate::SchedulerConfig;
 
 // ============================================================================
@@ -88,6 +90,8 @@ pub struct Scheduler {
     shutdown: Arc<AtomicBool>,
     /// Number of active workers.
     active_workers: Arc<AtomicUsize>,
+    /// Number of fibers currently executing on a worker.
+    running: Arc<AtomicUsize>,
     /// Global cancellation source for shutdown.
     cancellation_source: CancellationSource,
     /// Global cancellation token.
@@ -111,6 +115,7 @@ impl Scheduler {
         let fibers = Arc::new(Mutex::new(HashMap::new()));
         let shutdown = Arc::new(AtomicBool::new(false));
         let active_workers = Arc::new(AtomicUsize::new(0));
+        let running = Arc::new(AtomicUsize::new(0));
 
         // Create global cancellation source for shutdown
         let cancellation_source = CancellationSource::new();
@@ -139,6 +144,7 @@ impl Scheduler {
             stealers,
             shutdown,
             active_workers,
+            running,
             cancellation_source,
             cancellation_token,
             signal_handler: None,
@@ -217,6 +223,7 @@ impl Scheduler {
                 self.stealers.clone(),
                 self.shutdown.clone(),
                 self.active_workers.clone(),
+                self.running.clone(),
                 self.cancellation_token.clone(),
             );
 
@@ -290,6 +297,42 @@ impl Scheduler {
         installed
     }
 
+    /// Turn the rest of a fiber into a continuation.
+    ///
+    /// The returned closure spawns `task` with its argument as a new fiber.
+    /// Hand it to anything that completes later (a signal, an I/O
+    /// operation, a child exit) to park the fiber without holding a worker
+    /// or a fiber slot. The fiber keeps the fiber-local storage of the
+    /// context that parked it.
+    pub fn resume_in_fiber<T, F>(&self, task: F) -> impl FnOnce(T) + Send + 'static
+    where
+        T: Send + 'static,
+        F: FnOnce(T) + Send + 'static,
+    {
+        let fibers = self.fibers.clone();
+        let global_queue = self.global_queue.clone();
+        let config = FiberConfig::default().with_cancellation(self.cancellation_token.clone());
+        let locals = FiberContext::inherited();
+        move |value: T| {
+            let mut fiber = Fiber::new(move || task(value), config);
+            fiber.set_local_storage(locals);
+            let id = fiber.id;
+            fibers.lock().insert(id, fiber);
+            global_queue.push(id);
+        }
+    }
+
+    /// Park a fiber until a signal in `set` arrives.
+    ///
+    /// `task` is the rest of the fiber; it is spawned with the received
+    /// signal once the event loop dispatches it.
+    pub fn await_signal<F>(&self, set: SignalSet, task: F)
+    where
+        F: FnOnce(Signal) + Send + 'static,
+    {
+        signal::await_signal(set, self.resume_in_fiber(task));
+    }
+
     /// Check if a shutdown signal has been received.
     pub fn signal_shutdown_requested(&self) -> bool {
         signal::shutdown_requested()
@@ -317,6 +360,7 @@ impl Scheduler {
                 self.stealers.clone(),
                 self.shutdown.clone(),
                 self.active_workers.clone(),
+                self.running.clone(),
                 self.cancellation_token.clone(),
             );
 
@@ -330,22 +374,28 @@ impl Scheduler {
             self.workers[i].thread = Some(handle);
         }
 
-        // Monitor for signals in the main thread
+        // Event loop: wait on I/O and signals, and wake parked fibers
         while !self.shutdown.load(Ordering::Acquire) && !self.cancellation_token.is_cancelled() {
+            io::poll_events(std::time::Duration::from_millis(10));
+
             // Check for OS signal
             if signal::shutdown_requested() {
                 self.shutdown_with_reason("signal received");
                 break;
             }
 
-            // Check if all fibers are done
-            if self.active_fiber_count() == 0 && self.runnable_fiber_count() == 0 {
+            // Check if all fibers are done, including ones parked on signals
+            // or I/O. The parked counts are read first: a woken continuation
+            // leaves them only after it has been enqueued, so a fiber moving
+            // from parked to runnable is seen in one place or the other.
+            if signal::parked_count() == 0
+                && io::parked_count() == 0
+                && self.active_fiber_count() == 0
+                && self.runnable_fiber_count() == 0
+            {
                 self.shutdown();
                 break;
             }
-
-            // Small sleep to avoid busy-waiting
-            thread::sleep(std::time::Duration::from_millis(10));
         }
 
         // Wait for all workers to finish
@@ -367,8 +417,12 @@ impl Scheduler {
     }
 
     /// Get the number of active fibers.
+    ///
+    /// Includes fibers currently executing, which are out of the fiber
+    /// table while they run.
     pub fn active_fiber_count(&self) -> usize {
-        self.fibers.lock().len()
+        let fibers = self.fibers.lock();
+        fibers.len() + self.running.load(Ordering::Acquire)
     }
 
     /// Get the number of runnable fibers.
@@ -407,6 +461,8 @@ pub struct Worker {
     shutdown: Arc<AtomicBool>,
     /// Active worker count.
     active_workers: Arc<AtomicUsize>,
+    /// Count of fibers executing on any worker.
+    running: Arc<AtomicUsize>,
     /// Cancellation token for shutdown detection.
     cancellation_token: CancellationToken,
 }
@@ -420,6 +476,7 @@ impl Worker {
         stealers: Vec<Stealer<FiberId>>,
         shutdown: Arc<AtomicBool>,
         active_workers: Arc<AtomicUsize>,
+        running: Arc<AtomicUsize>,
         cancellation_token: CancellationToken,
     ) -> Self {
         Self {
@@ -429,6 +486,7 @@ impl Worker {
             stealers,
             shutdown,
             active_workers,
+            running,
             cancellation_token,
         }
     }
@@ -491,7 +549,17 @@ impl Worker {
     }
 
     /// Run a fiber to completion or suspension.
+    ///
+    /// The fiber counts as running from before it leaves the fiber table
+    /// until after it is reinserted or dropped, so `active_fiber_count`
+    /// never sees it in neither place.
     fn run_fiber(&self, fiber_id: FiberId) {
+        self.running.fetch_add(1, Ordering::AcqRel);
+        self.run_fiber_inner(fiber_id);
+        self.running.fetch_sub(1, Ordering::AcqRel);
+    }
+
+    fn run_fiber_inner(&self, fiber_id: FiberId) {
         // Get the fiber
         let mut fiber = {
             let mut fibers = self.fibers.lock();
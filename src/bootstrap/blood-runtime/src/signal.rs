@@ -1,13 +1,24 @@
 //! Signal Handling
 //!
 //! This module provides signal handling infrastructure for the Blood runtime.
-//! It supports graceful shutdown on SIGTERM/SIGINT and configuration reload on SIGHUP.
+//! It supports graceful shutdown on SIGTERM/SIGINT, configuration reload on SIGHUP,
+//! and child-exit notification on SIGCHLD.
 //!
 //! # Platform Support
 //!
-//! - **Unix**: Full support for SIGTERM, SIGINT, SIGHUP
+//! - **Unix**: Full support for SIGTERM, SIGINT, SIGHUP, SIGCHLD
 //! - **Windows**: Basic support for Ctrl+C (SIGINT equivalent)
 //!
+//! # Delivery
+//!
+//! On Unix the handler only updates atomics and writes the signal number to a
+//! non-blocking self-pipe, which keeps it async-signal-safe. The read end of
+//! the pipe ([`signal_fd`]) is registered with the runtime's global
+//! [`IoReactor`](crate::io::IoReactor) by the event loop
+//! ([`io::poll_events`](crate::io::poll_events)); [`dispatch_pending`] then
+//! drains it and wakes everything parked in [`await_signal`]. A parked waiter is just a boxed continuation, so
+//! thousands of fibers can wait for a signal without holding a worker thread.
+//!
 //! # Usage
 //!
 //! ```rust,ignore
@@ -24,11 +35,15 @@
 //!
 //! // Wait for shutdown with timeout
 //! handler.wait_for_shutdown(Duration::from_secs(5));
+//!
+//! // Park a continuation until the next SIGHUP
+//! signal::await_signal(SignalSet::of(Signal::Hup), |_| reload_config());
 //! ```
 
-use std::sync::atomic::{AtomicBool, AtomicU8, Ordering};
-use std::sync::{Arc, Condvar, Mutex};
-use std::time::Duration;
+use parking_lot::Mutex;
+use std::sync::atomic::{AtomicBool, AtomicU64, AtomicU8, AtomicUsize, Ordering};
+use std::sync::Arc;
+use std::time::{Duration, Instant};
 
 /// Signal types that can be handled.
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
@@ -42,8 +57,13 @@ pub enum Signal {
     Int = 2,
     /// SIGHUP - Hangup (typically config reload).
     Hup = 3,
+    /// SIGCHLD - A child process changed state.
+    Chld = 4,
 }
 
+/// Number of `Signal` variants, including `None`.
+const SIGNAL_KINDS: usize = 5;
+
 impl Signal {
     /// Convert from u8.
     pub fn from_u8(val: u8) -> Self {
@@ -51,6 +71,7 @@ impl Signal {
             1 => Signal::Term,
             2 => Signal::Int,
             3 => Signal::Hup,
+            4 => Signal::Chld,
             _ => Signal::None,
         }
     }
@@ -61,6 +82,48 @@ impl Signal {
     }
 }
 
+/// A set of signals to wait for.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub struct SignalSet(u8);
+
+impl SignalSet {
+    /// The shutdown signals (SIGTERM and SIGINT).
+    pub const SHUTDOWN: SignalSet = SignalSet((1 << Signal::Term as u8) | (1 << Signal::Int as u8));
+
+    /// The empty set.
+    pub const fn empty() -> Self {
+        SignalSet(0)
+    }
+
+    /// A set containing a single signal.
+    pub const fn of(signal: Signal) -> Self {
+        SignalSet(1 << signal as u8)
+    }
+
+    /// This set with `signal` added.
+    pub const fn with(self, signal: Signal) -> Self {
+        SignalSet(self.0 | (1 << signal as u8))
+    }
+
+    /// Check if the set contains `signal`.
+    pub fn contains(&self, signal: Signal) -> bool {
+        signal != Signal::None && self.0 & (1 << signal as u8) != 0
+    }
+
+    /// The lowest-numbered signal in the set, or `Signal::None`.
+    pub fn first(&self) -> Signal {
+        match (self.0 & !1).trailing_zeros() {
+            n if n < 8 => Signal::from_u8(n as u8),
+            _ => Signal::None,
+        }
+    }
+
+    /// Check if the set is empty.
+    pub fn is_empty(&self) -> bool {
+        self.0 & !1 == 0
+    }
+}
+
 /// Global shutdown flag for signal handlers.
 static SHUTDOWN_REQUESTED: AtomicBool = AtomicBool::new(false);
 
@@ -70,13 +133,154 @@ static LAST_SIGNAL: AtomicU8 = AtomicU8::new(0);
 /// Signal count (for detecting multiple signals).
 static SIGNAL_COUNT: AtomicU8 = AtomicU8::new(0);
 
-/// Shutdown notification channel.
-static SHUTDOWN_NOTIFY: std::sync::OnceLock<Arc<(Mutex<bool>, Condvar)>> =
-    std::sync::OnceLock::new();
+/// Longest a thread-level waiter sleeps before re-checking the shutdown flag.
+///
+/// Another thread may drain the self-pipe between our flag check and our
+/// poll, so waits are sliced rather than trusting a single wakeup.
+const WAIT_SLICE: Duration = Duration::from_millis(50);
+
+/// A continuation parked until one of `set` is dispatched.
+struct SignalWaiter {
+    set: SignalSet,
+    wake: Box<dyn FnOnce(Signal) + Send>,
+}
+
+/// Continuations parked in `await_signal`.
+static WAITERS: Mutex<Vec<SignalWaiter>> = Mutex::new(Vec::new());
+
+/// Number of parked continuations (readable without the lock). A woken
+/// waiter stays counted until its continuation has run, so anything it
+/// enqueues is visible before the count drops.
+static PARKED: AtomicUsize = AtomicUsize::new(0);
+
+/// Per-signal count of dispatched deliveries, updated under `WAITERS`.
+static DISPATCHED: [AtomicU64; SIGNAL_KINDS] = [
+    AtomicU64::new(0),
+    AtomicU64::new(0),
+    AtomicU64::new(0),
+    AtomicU64::new(0),
+    AtomicU64::new(0),
+];
+
+/// Most recently dispatched signal, including SIGCHLD.
+static LAST_DISPATCHED: AtomicU8 = AtomicU8::new(0);
+
+// ============================================================================
+// Self-pipe
+// ============================================================================
+
+#[cfg(unix)]
+mod self_pipe {
+    use std::sync::atomic::{AtomicI32, Ordering};
+    use std::sync::OnceLock;
+    use std::time::Duration;
+
+    static READ_FD: AtomicI32 = AtomicI32::new(-1);
+    static WRITE_FD: AtomicI32 = AtomicI32::new(-1);
+    static INIT: OnceLock<()> = OnceLock::new();
+
+    /// Create the pipe. Must run before any handler can fire.
+    pub(super) fn init() {
+        INIT.get_or_init(|| {
+            let mut fds = [-1i32; 2];
+            // SAFETY: `fds` is a valid two-element buffer.
+            let rc = unsafe { libc::pipe(fds.as_mut_ptr()) };
+            if rc != 0 {
+                return;
+            }
+            for fd in fds {
+                // SAFETY: `fd` was just returned by pipe().
+                unsafe {
+                    let fl = libc::fcntl(fd, libc::F_GETFL);
+                    libc::fcntl(fd, libc::F_SETFL, fl | libc::O_NONBLOCK);
+                    libc::fcntl(fd, libc::F_SETFD, libc::FD_CLOEXEC);
+                }
+            }
+            READ_FD.store(fds[0], Ordering::Release);
+            WRITE_FD.store(fds[1], Ordering::Release);
+        });
+    }
+
+    /// Read end of the pipe, if created.
+    pub(super) fn read_fd() -> Option<i32> {
+        let fd = READ_FD.load(Ordering::Acquire);
+        (fd >= 0).then_some(fd)
+    }
+
+    /// Record one signal. Async-signal-safe.
+    pub(super) fn notify(signal: u8) {
+        let fd = WRITE_FD.load(Ordering::Acquire);
+        if fd >= 0 {
+            // A full pipe already guarantees a wakeup, so EAGAIN is fine.
+            // SAFETY: writes one byte from a valid stack buffer.
+            unsafe {
+                libc::write(fd, &signal as *const u8 as *const libc::c_void, 1);
+            }
+        }
+    }
+
+    /// Drain pending signal numbers into `out`.
+    pub(super) fn drain(out: &mut Vec<u8>) {
+        let Some(fd) = read_fd() else { return };
+        let mut buf = [0u8; 64];
+        loop {
+            // SAFETY: reads into a valid stack buffer of the given length.
+            let n = unsafe { libc::read(fd, buf.as_mut_ptr() as *mut libc::c_void, buf.len()) };
+            if n <= 0 {
+                break;
+            }
+            out.extend_from_slice(&buf[..n as usize]);
+        }
+    }
+
+    /// Block until the pipe is readable or `timeout` elapses.
+    pub(super) fn wait_readable(timeout: Duration) {
+        let Some(fd) = read_fd() else {
+            std::thread::sleep(timeout);
+            return;
+        };
+        let mut pfd = libc::pollfd {
+            fd,
+            events: libc::POLLIN,
+            revents: 0,
+        };
+        let ms = timeout.as_millis().min(i32::MAX as u128) as i32;
+        // SAFETY: `pfd` is a single valid pollfd.
+        unsafe {
+            libc::poll(&mut pfd, 1, ms);
+        }
+    }
+}
+
+#[cfg(not(unix))]
+mod self_pipe {
+    use std::sync::Mutex;
+    use std::time::Duration;
+
+    // Console control handlers run on an ordinary thread, so a queue is enough.
+    static PENDING: Mutex<Vec<u8>> = Mutex::new(Vec::new());
+
+    pub(super) fn init() {}
+
+    pub(super) fn read_fd() -> Option<i32> {
+        None
+    }
+
+    pub(super) fn notify(signal: u8) {
+        if let Ok(mut pending) = PENDING.lock() {
+            pending.push(signal);
+        }
+    }
+
+    pub(super) fn drain(out: &mut Vec<u8>) {
+        if let Ok(mut pending) = PENDING.lock() {
+            out.append(&mut pending);
+        }
+    }
 
-/// Get or initialize the shutdown notification channel.
-fn get_shutdown_notify() -> &'static Arc<(Mutex<bool>, Condvar)> {
-    SHUTDOWN_NOTIFY.get_or_init(|| Arc::new((Mutex::new(false), Condvar::new())))
+    pub(super) fn wait_readable(timeout: Duration) {
+        std::thread::sleep(timeout.min(Duration::from_millis(10)));
+    }
 }
 
 /// Signal handler for graceful shutdown.
@@ -102,8 +306,7 @@ impl SignalHandler {
 
     /// Install signal handlers.
     ///
-    /// This installs handlers for SIGTERM, SIGINT, and optionally SIGHUP
-    /// based on the runtime configuration.
+    /// This installs handlers for SIGTERM, SIGINT, SIGHUP and SIGCHLD.
     ///
     /// Returns true if handlers were installed, false if already installed.
     pub fn install(&self) -> bool {
@@ -111,6 +314,8 @@ impl SignalHandler {
             return false; // Already installed
         }
 
+        self_pipe::init();
+
         #[cfg(unix)]
         self.install_unix_handlers();
 
@@ -121,28 +326,35 @@ impl SignalHandler {
     }
 
     /// Install Unix signal handlers.
+    ///
+    /// Handlers are process-wide, so no dedicated thread is needed: whichever
+    /// thread takes the signal writes it to the self-pipe.
     #[cfg(unix)]
     fn install_unix_handlers(&self) {
-        use std::thread;
-
-        // Spawn a thread to handle signals
-        // We use a dedicated thread because signal handlers have severe restrictions
-        thread::Builder::new()
-            .name("blood-signal".into())
-            .spawn(|| {
-                use nix::sys::signal::{self, SigHandler, Signal as NixSignal};
-
-                // Set up signal handlers using the safer sigaction approach
-                unsafe {
-                    // SIGTERM - graceful shutdown
-                    let _ = signal::signal(NixSignal::SIGTERM, SigHandler::Handler(signal_handler));
-                    // SIGINT - Ctrl+C
-                    let _ = signal::signal(NixSignal::SIGINT, SigHandler::Handler(signal_handler));
-                    // SIGHUP - config reload (we treat as shutdown for now)
-                    let _ = signal::signal(NixSignal::SIGHUP, SigHandler::Handler(signal_handler));
-                }
-            })
-            .expect("failed to spawn signal handler thread");
+        use nix::sys::signal::{self, SaFlags, SigAction, SigHandler, SigSet, Signal as NixSignal};
+
+        let action = SigAction::new(
+            SigHandler::Handler(signal_handler),
+            SaFlags::SA_RESTART,
+            SigSet::empty(),
+        );
+        let chld_action = SigAction::new(
+            SigHandler::Handler(signal_handler),
+            SaFlags::SA_RESTART | SaFlags::SA_NOCLDSTOP,
+            SigSet::empty(),
+        );
+
+        // SAFETY: `signal_handler` is async-signal-safe (atomics and write(2)).
+        unsafe {
+            // SIGTERM - graceful shutdown
+            let _ = signal::sigaction(NixSignal::SIGTERM, &action);
+            // SIGINT - Ctrl+C
+            let _ = signal::sigaction(NixSignal::SIGINT, &action);
+            // SIGHUP - config reload
+            let _ = signal::sigaction(NixSignal::SIGHUP, &action);
+            // SIGCHLD - child exit, for non-blocking reaping
+            let _ = signal::sigaction(NixSignal::SIGCHLD, &chld_action);
+        }
     }
 
     /// Install Windows signal handlers.
@@ -194,19 +406,30 @@ impl SignalHandler {
         SIGNAL_COUNT.load(Ordering::SeqCst)
     }
 
-    /// Wait for a shutdown signal.
+    /// Wait for a shutdown signal, blocking the calling thread.
+    ///
+    /// Fibers should use [`await_signal`] with [`SignalSet::SHUTDOWN`]
+    /// instead, which parks only the fiber.
     ///
     /// Returns true if shutdown was requested, false if timeout elapsed.
     pub fn wait_for_shutdown(&self, timeout: Duration) -> bool {
-        let notify = get_shutdown_notify();
-        let (lock, cvar) = &**notify;
-
-        let guard = lock.lock().unwrap();
-        let result = cvar.wait_timeout_while(guard, timeout, |shutdown| !*shutdown);
-
-        match result {
-            Ok((guard, timeout_result)) => *guard && !timeout_result.timed_out(),
-            Err(_) => false,
+        let deadline = Instant::now().checked_add(timeout);
+        loop {
+            dispatch_pending();
+            if SHUTDOWN_REQUESTED.load(Ordering::SeqCst) {
+                return true;
+            }
+            let slice = match deadline {
+                Some(deadline) => {
+                    let remaining = deadline.saturating_duration_since(Instant::now());
+                    if remaining.is_zero() {
+                        return false;
+                    }
+                    remaining.min(WAIT_SLICE)
+                }
+                None => WAIT_SLICE,
+            };
+            self_pipe::wait_readable(slice);
         }
     }
 
@@ -219,38 +442,38 @@ impl SignalHandler {
 
     /// Reset the shutdown state.
     ///
-    /// This is mainly useful for testing.
+    /// This is mainly useful for testing. Undispatched signals are discarded.
     pub fn reset(&self) {
         SHUTDOWN_REQUESTED.store(false, Ordering::SeqCst);
         LAST_SIGNAL.store(0, Ordering::SeqCst);
         SIGNAL_COUNT.store(0, Ordering::SeqCst);
-
-        let notify = get_shutdown_notify();
-        let (lock, _) = &**notify;
-        if let Ok(mut guard) = lock.lock() {
-            *guard = false;
-        }
+        self_pipe::drain(&mut Vec::new());
     }
 }
 
 /// Handle a received signal.
+///
+/// Called from signal context on Unix, so this only touches atomics and
+/// the self-pipe; waiters are woken later by [`dispatch_pending`].
+///
+/// SIGCHLD only wakes its waiters. It must not show up in
+/// `last_signal`/`signal_count`, which drive the shutdown logic.
 fn handle_signal(signal: Signal) {
+    if signal == Signal::Chld {
+        self_pipe::notify(signal as u8);
+        return;
+    }
+
     // Store the signal
     LAST_SIGNAL.store(signal as u8, Ordering::SeqCst);
     SIGNAL_COUNT.fetch_add(1, Ordering::SeqCst);
 
-    // If it's a shutdown signal, set the flag and notify waiters
+    // If it's a shutdown signal, set the flag before waking anyone
     if signal.is_shutdown() {
         SHUTDOWN_REQUESTED.store(true, Ordering::SeqCst);
-
-        // Notify any threads waiting for shutdown
-        let notify = get_shutdown_notify();
-        let (lock, cvar) = &**notify;
-        if let Ok(mut guard) = lock.lock() {
-            *guard = true;
-            cvar.notify_all();
-        }
     }
+
+    self_pipe::notify(signal as u8);
 }
 
 /// Unix signal handler function.
@@ -259,14 +482,136 @@ fn handle_signal(signal: Signal) {
 #[cfg(unix)]
 extern "C" fn signal_handler(sig: i32) {
     let signal = match sig {
-        15 => Signal::Term, // SIGTERM
-        2 => Signal::Int,   // SIGINT
-        1 => Signal::Hup,   // SIGHUP
+        libc::SIGTERM => Signal::Term,
+        libc::SIGINT => Signal::Int,
+        libc::SIGHUP => Signal::Hup,
+        libc::SIGCHLD => Signal::Chld,
         _ => Signal::None,
     };
     handle_signal(signal);
 }
 
+// ============================================================================
+// Dispatch and Parking
+// ============================================================================
+
+/// Read end of the self-pipe, for registration with an I/O poller.
+///
+/// When it becomes readable, call [`dispatch_pending`]. Returns `None` until
+/// handlers are installed, and always on platforms without a self-pipe.
+pub fn signal_fd() -> Option<i32> {
+    self_pipe::read_fd()
+}
+
+/// Number of deliveries of any signal in `set` dispatched so far.
+///
+/// Pass the result to [`await_signal_after`] to avoid missing a signal
+/// that arrives between checking a condition and parking.
+pub fn dispatch_epoch(set: SignalSet) -> u64 {
+    (1..SIGNAL_KINDS)
+        .filter(|&i| set.contains(Signal::from_u8(i as u8)))
+        .map(|i| DISPATCHED[i].load(Ordering::Acquire))
+        .sum()
+}
+
+/// Park `k` until the next delivery of a signal in `set`.
+///
+/// `k` runs on whichever thread calls [`dispatch_pending`]; the scheduler
+/// uses this to re-spawn the parked fiber. Parking costs one boxed closure
+/// and no thread. If the set includes a shutdown signal and shutdown has
+/// already been requested, `k` runs immediately.
+pub fn await_signal<F>(set: SignalSet, k: F)
+where
+    F: FnOnce(Signal) + Send + 'static,
+{
+    await_signal_after(set, dispatch_epoch(set), k)
+}
+
+/// Like [`await_signal`], but `k` runs immediately if a signal in `set`
+/// was dispatched after `epoch` was read from [`dispatch_epoch`].
+pub fn await_signal_after<F>(set: SignalSet, epoch: u64, k: F)
+where
+    F: FnOnce(Signal) + Send + 'static,
+{
+    let shutdown = SHUTDOWN_REQUESTED.load(Ordering::SeqCst);
+    let immediate = {
+        let mut waiters = WAITERS.lock();
+        if dispatch_epoch(set) != epoch {
+            let last = Signal::from_u8(LAST_DISPATCHED.load(Ordering::SeqCst));
+            Some(if set.contains(last) { last } else { set.first() })
+        } else if shutdown && set.contains(Signal::Term) {
+            Some(Signal::Term)
+        } else if shutdown && set.contains(Signal::Int) {
+            Some(Signal::Int)
+        } else {
+            waiters.push(SignalWaiter {
+                set,
+                wake: Box::new(k),
+            });
+            PARKED.fetch_add(1, Ordering::AcqRel);
+            return;
+        }
+    };
+    if let Some(signal) = immediate {
+        k(signal);
+    }
+}
+
+/// Number of continuations currently parked in [`await_signal`].
+pub fn parked_count() -> usize {
+    PARKED.load(Ordering::Acquire)
+}
+
+/// Drain the self-pipe and wake every waiter whose set matches a received
+/// signal. Returns the number of waiters woken.
+pub fn dispatch_pending() -> usize {
+    let mut received = Vec::new();
+    self_pipe::drain(&mut received);
+    if received.is_empty() {
+        return 0;
+    }
+
+    let mut ready: Vec<(Signal, SignalWaiter)> = Vec::new();
+    {
+        let mut waiters = WAITERS.lock();
+        for &byte in &received {
+            let signal = Signal::from_u8(byte);
+            if signal == Signal::None {
+                continue;
+            }
+            DISPATCHED[signal as usize].fetch_add(1, Ordering::AcqRel);
+            LAST_DISPATCHED.store(byte, Ordering::SeqCst);
+            if waiters.iter().any(|w| w.set.contains(signal)) {
+                let (matched, parked): (Vec<_>, Vec<_>) = std::mem::take(&mut *waiters)
+                    .into_iter()
+                    .partition(|w| w.set.contains(signal));
+                *waiters = parked;
+                ready.extend(matched.into_iter().map(|w| (signal, w)));
+            }
+        }
+    }
+
+    let woken = ready.len();
+    for (signal, waiter) in ready {
+        (waiter.wake)(signal);
+        PARKED.fetch_sub(1, Ordering::AcqRel);
+    }
+    woken
+}
+
+/// Wait up to `timeout` for a signal, then dispatch whatever arrived.
+///
+/// This is the signal half of an event loop; it returns the number of
+/// waiters woken.
+pub fn poll_signals(timeout: Duration) -> usize {
+    let woken = dispatch_pending();
+    if woken > 0 {
+        return woken;
+    }
+    self_pipe::wait_readable(timeout);
+    dispatch_pending()
+}
+
 /// Global signal handler instance.
 static GLOBAL_HANDLER: std::sync::OnceLock<SignalHandler> = std::sync::OnceLock::new();
 
@@ -306,6 +651,7 @@ mod tests {
         assert_eq!(Signal::from_u8(1), Signal::Term);
         assert_eq!(Signal::from_u8(2), Signal::Int);
         assert_eq!(Signal::from_u8(3), Signal::Hup);
+        assert_eq!(Signal::from_u8(4), Signal::Chld);
         assert_eq!(Signal::from_u8(255), Signal::None);
     }
 
@@ -315,6 +661,18 @@ mod tests {
         assert!(Signal::Term.is_shutdown());
         assert!(Signal::Int.is_shutdown());
         assert!(!Signal::Hup.is_shutdown());
+        assert!(!Signal::Chld.is_shutdown());
+    }
+
+    #[test]
+    fn test_signal_set() {
+        let set = SignalSet::of(Signal::Hup).with(Signal::Chld);
+        assert!(set.contains(Signal::Hup));
+        assert!(set.contains(Signal::Chld));
+        assert!(!set.contains(Signal::Term));
+        assert!(!set.contains(Signal::None));
+        assert!(SignalSet::empty().is_empty());
+        assert!(SignalSet::SHUTDOWN.contains(Signal::Int));
     }
 
     #[test]
@@ -325,6 +683,13 @@ mod tests {
         assert_eq!(handler.signal_count(), 0);
     }
 
+    #[test]
+    fn test_child_exit_not_recorded() {
+        let handler = SignalHandler::new();
+        handle_signal(Signal::Chld);
+        assert_ne!(handler.last_signal(), Signal::Chld);
+    }
+
     #[test]
     fn test_request_shutdown() {
         let handler = SignalHandler::new();
@@ -0,0 +1,455 @@
+//! # Buffered Standard Output
+//!
+//! Output path for the runtime print builtins.
+//!
+//! Going through `print!` takes the global stdout lock and runs the `fmt`
+//! machinery on every call, and the no-newline variants used to flush after
+//! each one. Output-heavy programs spent most of their time there. This
+//! module keeps one output buffer per thread and writes it to file
+//! descriptor 1 directly:
+//!
+//! - a buffer is written out when it fills up;
+//! - when stdout is a terminal, it is also written out at each newline, so
+//!   interactive output still appears line by line;
+//! - the calling thread's buffer is written out before reading stdin,
+//!   before writing to stderr (runtime diagnostics use this module's
+//!   [`eprintln!`](crate::stdio::eprintln)) and before panic output;
+//! - a thread's buffer is written out when the thread or fiber running on
+//!   it finishes, and before it spawns, joins or parks, so output stays
+//!   ordered across those synchronization points;
+//! - every live thread's buffer is written out by an `atexit` hook and
+//!   before a fatal abort.
+//!
+//! Threads never share a buffer. Each buffer sits behind its own mutex,
+//! which only the exit flush ever contends, so printing takes no shared
+//! lock. Output from unsynchronized threads can interleave at buffer
+//! granularity rather than at call granularity. It never interleaves
+//! within a single write.
+//!
+//! Integers are written with a two-digits-at-a-time formatter instead of
+//! `fmt`. Stderr stays unbuffered but skips the `Stderr` lock as well.
+//!
+//! # Example
+//!
+//! ```rust
+//! use blood_runtime::stdio;
+//!
+//! let mut buf = [0u8; stdio::ITOA_LEN];
+//! assert_eq!(stdio::format_i64(-1234, &mut buf), b"-1234");
+//! ```
+
+use std::fmt;
+use std::io::Write;
+use std::sync::{Arc, Mutex, MutexGuard, Once, OnceLock, Weak};
+
+/// Size of each thread's stdout buffer.
+pub const STDOUT_BUFFER_SIZE: usize = 32 * 1024;
+
+/// Scratch space needed to format any `i64` or `u64`.
+pub const ITOA_LEN: usize = 20;
+
+/// Decimal digit pairs "00" through "99".
+const DIGIT_PAIRS: &[u8; 200] = b"\
+    0001020304050607080910111213141516171819\
+    2021222324252627282930313233343536373839\
+    4041424344454647484950515253545556575859\
+    6061626364656667686970717273747576777879\
+    8081828384858687888990919293949596979899";
+
+// ============================================================================
+// Integer Formatting
+// ============================================================================
+
+/// Format `n` in decimal into the tail of `buf`, returning the digits.
+pub fn format_u64(mut n: u64, buf: &mut [u8; ITOA_LEN]) -> &[u8] {
+    let mut pos = ITOA_LEN;
+    while n >= 100 {
+        let pair = (n % 100) as usize * 2;
+        n /= 100;
+        pos -= 2;
+        buf[pos..pos + 2].copy_from_slice(&DIGIT_PAIRS[pair..pair + 2]);
+    }
+    if n >= 10 {
+        let pair = n as usize * 2;
+        pos -= 2;
+        buf[pos..pos + 2].copy_from_slice(&DIGIT_PAIRS[pair..pair + 2]);
+    } else {
+        pos -= 1;
+        buf[pos] = b'0' + n as u8;
+    }
+    &buf[pos..]
+}
+
+/// Format `n` in decimal, with a leading `-` if negative.
+pub fn format_i64(n: i64, buf: &mut [u8; ITOA_LEN]) -> &[u8] {
+    if n >= 0 {
+        return format_u64(n as u64, buf);
+    }
+    // |i64::MIN| has 19 digits, so the sign always fits.
+    let pos = ITOA_LEN - format_u64(n.unsigned_abs(), buf).len() - 1;
+    buf[pos] = b'-';
+    &buf[pos..]
+}
+
+// ============================================================================
+// Stdout Buffer
+// ============================================================================
+
+/// Per-thread pending stdout bytes.
+struct StdoutBuffer {
+    buf: Vec<u8>,
+}
+
+impl StdoutBuffer {
+    fn flush(&mut self) {
+        if !self.buf.is_empty() {
+            write_fd(STDOUT_FD, &self.buf);
+            self.buf.clear();
+        }
+    }
+
+    /// Allocate the buffer on first use: threads that only pass through a
+    /// flush point never print.
+    fn reserve(&mut self) {
+        if self.buf.capacity() == 0 {
+            self.buf.reserve_exact(STDOUT_BUFFER_SIZE);
+        }
+    }
+
+    /// Append `bytes`, plus a newline if `newline` is set.
+    fn write(&mut self, bytes: &[u8], newline: bool) {
+        self.reserve();
+        let needed = bytes.len() + newline as usize;
+        if self.buf.len() + needed > STDOUT_BUFFER_SIZE {
+            self.flush();
+            if needed > STDOUT_BUFFER_SIZE {
+                // Larger than the buffer: write through, don't copy.
+                write_fd(STDOUT_FD, bytes);
+                if newline {
+                    write_fd(STDOUT_FD, b"\n");
+                }
+                return;
+            }
+        }
+        self.buf.extend_from_slice(bytes);
+        if newline {
+            self.buf.push(b'\n');
+            if line_buffered() {
+                self.flush();
+            }
+        } else if line_buffered() && bytes.contains(&b'\n') {
+            self.flush();
+        }
+    }
+}
+
+impl Drop for StdoutBuffer {
+    fn drop(&mut self) {
+        self.flush();
+    }
+}
+
+type SharedBuffer = Arc<Mutex<StdoutBuffer>>;
+
+thread_local! {
+    static STDOUT_BUFFER: SharedBuffer = register_buffer();
+}
+
+/// Every thread's buffer, so the exit hook can reach them all. Entries
+/// die with their thread.
+static BUFFERS: Mutex<Vec<Weak<Mutex<StdoutBuffer>>>> = Mutex::new(Vec::new());
+
+/// Lock a buffer, even if a panic poisoned it; the bytes are still valid.
+fn lock(buffer: &Mutex<StdoutBuffer>) -> MutexGuard<'_, StdoutBuffer> {
+    buffer.lock().unwrap_or_else(|e| e.into_inner())
+}
+
+/// Create this thread's buffer and add it to the registry.
+fn register_buffer() -> SharedBuffer {
+    static EXIT_FLUSH: Once = Once::new();
+    EXIT_FLUSH.call_once(register_exit_flush);
+    let buffer = Arc::new(Mutex::new(StdoutBuffer { buf: Vec::new() }));
+    let mut buffers = BUFFERS.lock().unwrap_or_else(|e| e.into_inner());
+    buffers.retain(|b| b.strong_count() > 0);
+    buffers.push(Arc::downgrade(&buffer));
+    buffer
+}
+
+/// Whether stdout is a terminal, checked once.
+fn line_buffered() -> bool {
+    static IS_TTY: OnceLock<bool> = OnceLock::new();
+    *IS_TTY.get_or_init(|| is_terminal(STDOUT_FD))
+}
+
+/// Run `f` on this thread's buffer, or write straight through if the
+/// thread's buffer has already been destroyed (late output during exit).
+fn with_stdout<F: FnOnce(&mut StdoutBuffer)>(f: F) {
+    let mut f = Some(f);
+    let buffered = STDOUT_BUFFER.try_with(|buffer| (f.take().unwrap())(&mut *lock(buffer)));
+    if buffered.is_err() {
+        let mut direct = StdoutBuffer { buf: Vec::new() };
+        (f.take().unwrap())(&mut direct);
+    }
+}
+
+/// Write `bytes` to stdout.
+pub fn print_bytes(bytes: &[u8]) {
+    with_stdout(|out| out.write(bytes, false));
+}
+
+/// Write `bytes` and a newline to stdout.
+pub fn println_bytes(bytes: &[u8]) {
+    with_stdout(|out| out.write(bytes, true));
+}
+
+/// Write a signed integer to stdout, followed by a newline if `newline`.
+pub fn print_i64(n: i64, newline: bool) {
+    let mut digits = [0u8; ITOA_LEN];
+    let digits = format_i64(n, &mut digits);
+    with_stdout(|out| out.write(digits, newline));
+}
+
+/// Write an unsigned integer to stdout, followed by a newline if `newline`.
+pub fn print_u64(n: u64, newline: bool) {
+    let mut digits = [0u8; ITOA_LEN];
+    let digits = format_u64(n, &mut digits);
+    with_stdout(|out| out.write(digits, newline));
+}
+
+/// Write formatted output to stdout, followed by a newline if `newline`.
+///
+/// For values without a dedicated fast path (floats); formats straight
+/// into the buffer.
+pub fn print_fmt(args: fmt::Arguments<'_>, newline: bool) {
+    with_stdout(|out| {
+        out.reserve();
+        if out.buf.len() + 64 > STDOUT_BUFFER_SIZE {
+            out.flush();
+        }
+        let _ = out.buf.write_fmt(args);
+        if newline {
+            out.buf.push(b'\n');
+        }
+        if out.buf.len() >= STDOUT_BUFFER_SIZE || (newline && line_buffered()) {
+            out.flush();
+        }
+    });
+}
+
+/// Write out this thread's pending stdout bytes.
+pub fn flush_stdout() {
+    with_stdout(StdoutBuffer::flush);
+}
+
+/// Write out the pending stdout bytes of every live thread, the calling
+/// thread's last.
+pub fn flush_all_stdout() {
+    let own = STDOUT_BUFFER.try_with(Arc::clone).ok();
+    let others: Vec<SharedBuffer> = BUFFERS
+        .lock()
+        .unwrap_or_else(|e| e.into_inner())
+        .iter()
+        .filter_map(Weak::upgrade)
+        .collect();
+    for buffer in &others {
+        if !own.as_ref().is_some_and(|own| Arc::ptr_eq(own, buffer)) {
+            lock(buffer).flush();
+        }
+    }
+    if let Some(own) = own {
+        lock(&own).flush();
+    }
+}
+
+/// Flush every thread's stdout and abort the process.
+///
+/// `abort` skips `atexit` hooks, so the runtime's fatal-error paths go
+/// through here to keep the output that preceded the failure.
+pub fn abort() -> ! {
+    flush_all_stdout();
+    std::process::abort()
+}
+
+/// Write `bytes` to stderr, followed by a newline if `newline`.
+///
+/// Stderr is unbuffered. This thread's stdout is flushed first, so output
+/// to a shared terminal stays in program order.
+pub fn eprint_bytes(bytes: &[u8], newline: bool) {
+    flush_stdout();
+    if newline {
+        write_fd_pair(STDERR_FD, bytes, b"\n");
+    } else {
+        write_fd(STDERR_FD, bytes);
+    }
+}
+
+/// `eprintln!` for runtime diagnostics: flushes this thread's stdout
+/// first, like [`eprint_bytes`]. Modules that report errors import it in
+/// place of the std macro.
+macro_rules! eprintln {
+    ($($arg:tt)*) => {{
+        $crate::stdio::flush_stdout();
+        ::std::eprintln!($($arg)*);
+    }};
+}
+pub(crate) use eprintln;
+
+// ============================================================================
+// Platform Layer
+// ============================================================================
+
+const STDOUT_FD: i32 = 1;
+const STDERR_FD: i32 = 2;
+
+#[cfg(unix)]
+fn is_terminal(fd: i32) -> bool {
+    // SAFETY: isatty only inspects the descriptor.
+    unsafe { libc::isatty(fd) == 1 }
+}
+
+#[cfg(not(unix))]
+fn is_terminal(fd: i32) -> bool {
+    use std::io::IsTerminal;
+    if fd == STDOUT_FD {
+        std::io::stdout().is_terminal()
+    } else {
+        std::io::stderr().is_terminal()
+    }
+}
+
+/// Flush every thread's buffer when the process exits normally.
+#[cfg(unix)]
+fn register_exit_flush() {
+    extern "C" fn flush_at_exit() {
+        flush_all_stdout();
+    }
+    // SAFETY: registering a plain extern "C" function.
+    unsafe {
+        libc::atexit(flush_at_exit);
+    }
+}
+
+#[cfg(not(unix))]
+fn register_exit_flush() {}
+
+/// Write all of `bytes` to `fd`, retrying on interruption and waiting out
+/// a non-blocking descriptor. Errors (a closed pipe) drop the output, as
+/// `print!` would after reporting them.
+#[cfg(unix)]
+fn write_fd(fd: i32, mut bytes: &[u8]) {
+    while !bytes.is_empty() {
+        // SAFETY: `bytes` is valid for `bytes.len()` bytes.
+        let n = unsafe { libc::write(fd, bytes.as_ptr() as *const libc::c_void, bytes.len()) };
+        if n >= 0 {
+            bytes = &bytes[n as usize..];
+            continue;
+        }
+        if !retry_write(fd) {
+            return;
+        }
+    }
+}
+
+/// Write `a` then `b` to `fd` in one system call where possible.
+#[cfg(unix)]
+fn write_fd_pair(fd: i32, a: &[u8], b: &[u8]) {
+    let iov = [
+        libc::iovec {
+            iov_base: a.as_ptr() as *mut libc::c_void,
+            iov_len: a.len(),
+        },
+        libc::iovec {
+            iov_base: b.as_ptr() as *mut libc::c_void,
+            iov_len: b.len(),
+        },
+    ];
+    loop {
+        // SAFETY: both iovecs describe live slices.
+        let n = unsafe { libc::writev(fd, iov.as_ptr(), 2) };
+        if n >= 0 {
+            let n = n as usize;
+            if n < a.len() {
+                write_fd(fd, &a[n..]);
+                write_fd(fd, b);
+            } else {
+                write_fd(fd, &b[n - a.len()..]);
+            }
+            return;
+        }
+        if !retry_write(fd) {
+            return;
+        }
+    }
+}
+
+/// After a failed write, decide whether to try again.
+#[cfg(unix)]
+fn retry_write(fd: i32) -> bool {
+    match std::io::Error::last_os_error().raw_os_error() {
+        Some(libc::EINTR) => true,
+        Some(libc::EAGAIN) => {
+            let mut pfd = libc::pollfd {
+                fd,
+                events: libc::POLLOUT,
+                revents: 0,
+            };
+            // SAFETY: one valid pollfd.
+            unsafe { libc::poll(&mut pfd, 1, -1) };
+            true
+        }
+        _ => false,
+    }
+}
+
+#[cfg(not(unix))]
+fn write_fd(fd: i32, bytes: &[u8]) {
+    if fd == STDOUT_FD {
+        let _ = std::io::stdout().write_all(bytes);
+        let _ = std::io::stdout().flush();
+    } else {
+        let _ = std::io::stderr().write_all(bytes);
+    }
+}
+
+#[cfg(not(unix))]
+fn write_fd_pair(fd: i32, a: &[u8], b: &[u8]) {
+    write_fd(fd, a);
+    write_fd(fd, b);
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn fmt_u(n: u64) -> String {
+        let mut buf = [0u8; ITOA_LEN];
+        String::from_utf8(format_u64(n, &mut buf).to_vec()).unwrap()
+    }
+
+    fn fmt_i(n: i64) -> String {
+        let mut buf = [0u8; ITOA_LEN];
+        String::from_utf8(format_i64(n, &mut buf).to_vec()).unwrap()
+    }
+
+    #[test]
+    fn test_format_u64_matches_display() {
+        let mut n: u64 = 1;
+        for _ in 0..20 {
+            for m in [n - 1, n, n + 1, n / 3 * 2] {
+                assert_eq!(fmt_u(m), m.to_string());
+            }
+            n = n.saturating_mul(10);
+        }
+        assert_eq!(fmt_u(0), "0");
+        assert_eq!(fmt_u(u64::MAX), u64::MAX.to_string());
+    }
+
+    #[test]
+    fn test_format_i64_matches_display() {
+        for n in [0, 1, -1, 9, -9, 10, -10, 99, -100, 12345, -987654321] {
+            assert_eq!(fmt_i(n), n.to_string());
+        }
+        assert_eq!(fmt_i(i64::MIN), i64::MIN.to_string());
+        assert_eq!(fmt_i(i64::MAX), i64::MAX.to_string());
+    }
+}
@@ -16,7 +16,7 @@
 //! This module provides the minimal Rust support required for bootstrap.
 
 use std::fmt;
-use std::io::{self, Write};
+use std::io;
 
 /// Effect identifier.
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
@@ -528,34 +528,31 @@ pub mod io_ops {
 
     /// Print to stdout.
     pub fn print(s: &str) -> StdResult<()> {
-        print!("{}", s);
-        io::stdout()
-            .flush()
-            .map_err(|e| StdError::new(StdErrorKind::IoError, e.to_string()))
+        crate::stdio::print_bytes(s.as_bytes());
+        Ok(())
     }
 
     /// Print line to stdout.
     pub fn println(s: &str) -> StdResult<()> {
-        println!("{}", s);
+        crate::stdio::println_bytes(s.as_bytes());
         Ok(())
     }
 
     /// Print to stderr.
     pub fn eprint(s: &str) -> StdResult<()> {
-        eprint!("{}", s);
-        io::stderr()
-            .flush()
-            .map_err(|e| StdError::new(StdErrorKind::IoError, e.to_string()))
+        crate::stdio::eprint_bytes(s.as_bytes(), false);
+        Ok(())
     }
 
     /// Print line to stderr.
     pub fn eprintln(s: &str) -> StdResult<()> {
-        eprintln!("{}", s);
+        crate::stdio::eprint_bytes(s.as_bytes(), true);
         Ok(())
     }
 
     /// Read line from stdin.
     pub fn read_line() -> StdResult<String> {
+        crate::stdio::flush_stdout();
         let mut line = String::new();
         io::stdin()
             .read_line(&mut line)
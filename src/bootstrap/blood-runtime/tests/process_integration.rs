@@ -0,0 +1,150 @@
+//! Subprocess integration tests.
+//!
+//! These tests spawn real child processes from fibers and check that
+//! waiting for them and reading their pipes parks the fiber on the
+//! reactor instead of blocking a worker thread.
+//!
+//! Run with: cargo test --test process_integration
+
+#![cfg(unix)]
+
+use blood_runtime::process::{Command, Output, ProcessStatus, Stdio};
+use blood_runtime::scheduler::Scheduler;
+use blood_runtime::SchedulerConfig;
+use parking_lot::Mutex;
+use std::io::{self, Write};
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use std::sync::Arc;
+use std::thread;
+use std::time::{Duration, Instant};
+
+/// Number of fibers that each spawn one child.
+const CHILD_FIBERS: usize = 1_000;
+
+/// Worker threads in the scheduler under test.
+const WORKERS: usize = 4;
+
+/// Raise the open file limit so a thousand children's pipes fit.
+fn raise_fd_limit() {
+    // SAFETY: getrlimit/setrlimit on a stack-allocated rlimit.
+    unsafe {
+        let mut limit: libc::rlimit = std::mem::zeroed();
+        if libc::getrlimit(libc::RLIMIT_NOFILE, &mut limit) == 0 {
+            limit.rlim_cur = limit.rlim_max;
+            libc::setrlimit(libc::RLIMIT_NOFILE, &limit);
+        }
+    }
+}
+
+/// Current number of threads in this process, if /proc is available.
+fn thread_count() -> Option<usize> {
+    let status = std::fs::read_to_string("/proc/self/status").ok()?;
+    status
+        .lines()
+        .find_map(|line| line.strip_prefix("Threads:"))
+        .and_then(|n| n.trim().parse().ok())
+}
+
+#[test]
+fn test_thousand_children_without_blocking_workers() {
+    raise_fd_limit();
+
+    let input = std::env::temp_dir().join(format!("blood_proc_{}.txt", std::process::id()));
+    {
+        let mut file = std::fs::File::create(&input).unwrap();
+        writeln!(file, "alpha\nbeta\ngamma").unwrap();
+    }
+    let input = input.to_string_lossy().into_owned();
+
+    let mut scheduler = Scheduler::new(SchedulerConfig {
+        num_workers: WORKERS,
+        ..Default::default()
+    });
+
+    let completed = Arc::new(AtomicUsize::new(0));
+    for i in 0..CHILD_FIBERS {
+        let completed = completed.clone();
+        let input = input.clone();
+        match i % 3 {
+            0 => {
+                let resume = scheduler.resume_in_fiber(move |status: io::Result<ProcessStatus>| {
+                    let status = status.expect("wait failed");
+                    assert!(status.success());
+                    completed.fetch_add(1, Ordering::SeqCst);
+                });
+                scheduler.spawn(move || {
+                    let child = Command::new("true").spawn().expect("failed to spawn true");
+                    child.wait_async(resume);
+                });
+            }
+            1 => {
+                let resume = scheduler.resume_in_fiber(move |output: io::Result<Output>| {
+                    let output = output.expect("output failed");
+                    assert!(output.status.success());
+                    assert_eq!(output.stdout, b"alpha\nbeta\ngamma\n");
+                    completed.fetch_add(1, Ordering::SeqCst);
+                });
+                scheduler.spawn(move || {
+                    Command::new("cat").arg(&input).output_async(resume);
+                });
+            }
+            _ => {
+                let lines = Arc::new(Mutex::new(Vec::new()));
+                let collected = lines.clone();
+                let resume = scheduler.resume_in_fiber(move |result: io::Result<()>| {
+                    result.expect("read failed");
+                    assert_eq!(*lines.lock(), ["alpha", "beta", "gamma"]);
+                    completed.fetch_add(1, Ordering::SeqCst);
+                });
+                scheduler.spawn(move || {
+                    let mut child = Command::new("cat")
+                        .arg(&input)
+                        .stdout(Stdio::Piped)
+                        .spawn()
+                        .expect("failed to spawn cat");
+                    let stdout = child.stdout().expect("stdout not piped");
+                    stdout.lines_async(move |line| collected.lock().push(line), resume);
+                    // Reap the child once it exits; its output is already
+                    // being streamed.
+                    child.wait_async(|_| {});
+                });
+            }
+        }
+    }
+
+    // Sample the thread count while the children run.
+    let baseline = thread_count();
+    let max_threads = Arc::new(AtomicUsize::new(0));
+    let stop = Arc::new(AtomicBool::new(false));
+    let sampler = {
+        let max_threads = max_threads.clone();
+        let stop = stop.clone();
+        thread::spawn(move || {
+            while !stop.load(Ordering::SeqCst) {
+                if let Some(n) = thread_count() {
+                    max_threads.fetch_max(n, Ordering::SeqCst);
+                }
+                thread::sleep(Duration::from_millis(5));
+            }
+        })
+    };
+
+    let start = Instant::now();
+    scheduler.run_with_signal_handling();
+    stop.store(true, Ordering::SeqCst);
+    sampler.join().unwrap();
+    let _ = std::fs::remove_file(&input);
+
+    assert_eq!(completed.load(Ordering::SeqCst), CHILD_FIBERS);
+    assert!(start.elapsed() < Duration::from_secs(60));
+
+    // Workers plus the sampler and the test harness; nothing per child.
+    if let (Some(baseline), max) = (baseline, max_threads.load(Ordering::SeqCst)) {
+        assert!(
+            max <= baseline + WORKERS + 2,
+            "thread count grew from {} to {}",
+            baseline,
+            max
+        );
+    }
+}
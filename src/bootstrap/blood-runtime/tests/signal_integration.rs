@@ -0,0 +1,111 @@
+//! Signal delivery integration tests.
+//!
+//! These tests send real signals to the test process and check that
+//! fibers parked on them are woken through the self-pipe, without any
+//! thread blocking per waiter.
+//!
+//! Run with: cargo test --test signal_integration
+//!
+//! Only non-shutdown signals are raised, so tests in this binary may run
+//! concurrently without tearing each other's schedulers down.
+
+#![cfg(unix)]
+
+use blood_runtime::process::Command;
+use blood_runtime::scheduler::Scheduler;
+use blood_runtime::signal::{self, Signal, SignalSet};
+use blood_runtime::SchedulerConfig;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::{mpsc, Arc};
+use std::thread;
+use std::time::{Duration, Instant};
+
+/// Number of fibers parked on SIGHUP.
+const PARKED_FIBERS: usize = 10_000;
+
+fn raise(sig: i32) {
+    // SAFETY: signalling our own process with a handled signal.
+    unsafe {
+        libc::kill(libc::getpid(), sig);
+    }
+}
+
+#[test]
+fn test_sighup_wakes_parked_fibers() {
+    signal::install_handlers();
+
+    let mut scheduler = Scheduler::new(SchedulerConfig {
+        num_workers: 4,
+        ..Default::default()
+    });
+
+    let woken = Arc::new(AtomicUsize::new(0));
+    for _ in 0..PARKED_FIBERS {
+        let woken = woken.clone();
+        scheduler.await_signal(SignalSet::of(Signal::Hup), move |sig| {
+            assert_eq!(sig, Signal::Hup);
+            woken.fetch_add(1, Ordering::SeqCst);
+        });
+    }
+
+    // Parked fibers hold no fiber slots and no workers.
+    assert!(signal::parked_count() >= PARKED_FIBERS);
+    assert_eq!(scheduler.active_fiber_count(), 0);
+
+    let sender = thread::spawn(|| {
+        thread::sleep(Duration::from_millis(50));
+        raise(libc::SIGHUP);
+    });
+
+    // Returns once every woken fiber has run and nothing is left parked.
+    let start = Instant::now();
+    scheduler.run_with_signal_handling();
+    sender.join().unwrap();
+
+    assert_eq!(woken.load(Ordering::SeqCst), PARKED_FIBERS);
+    assert!(start.elapsed() < Duration::from_secs(30));
+}
+
+#[test]
+fn test_woken_waiter_counts_as_parked_until_resumed() {
+    signal::install_handlers();
+
+    // The continuation runs inside dispatch; by then it must still be
+    // counted, or an exit check on another thread could see nothing parked
+    // and nothing runnable.
+    let (tx, rx) = mpsc::channel();
+    signal::await_signal(SignalSet::of(Signal::Hup), move |_| {
+        tx.send(signal::parked_count()).unwrap();
+    });
+    raise(libc::SIGHUP);
+
+    let deadline = Instant::now() + Duration::from_secs(10);
+    let parked_while_resuming = loop {
+        if let Ok(count) = rx.try_recv() {
+            break count;
+        }
+        assert!(Instant::now() < deadline, "waiter was never woken");
+        signal::poll_signals(Duration::from_millis(10));
+    };
+    assert!(parked_while_resuming >= 1);
+}
+
+#[test]
+fn test_sigchld_reaps_without_blocking() {
+    let (tx, rx) = mpsc::channel();
+    let child = Command::new("true").spawn().expect("failed to spawn true");
+    child.on_exit(move |status| {
+        tx.send(status.map(|s| s.success())).unwrap();
+    });
+
+    // Drive the dispatcher the way the scheduler's event loop does.
+    let deadline = Instant::now() + Duration::from_secs(10);
+    loop {
+        if let Ok(result) = rx.try_recv() {
+            assert!(result.expect("wait failed"));
+            break;
+        }
+        assert!(Instant::now() < deadline, "child was never reaped");
+        signal::poll_signals(Duration::from_millis(10));
+    }
+}
@@ -0,0 +1,424 @@
+//! Directory Mode
+//!
+//! Checks or formats many files on a pool of worker threads. Results are
+//! streamed back to the caller as each file finishes, so output starts
+//! before the slowest file is done.
+//!
+//! A [`FormatCache`] remembers the content hash of every file already known
+//! to be formatted under the current configuration; such files are skipped
+//! without being tokenized. Cache keys combine the file content with a hash
+//! of the configuration and [`FORMATTER_REVISION`], so changing either
+//! invalidates every entry.
+
+use std::collections::HashSet;
+use std::fs;
+use std::io;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use std::sync::{mpsc, Mutex};
+
+use bloodc::content::hash::ContentHasher;
+use bloodc::content::{BuildCache, ContentHash};
+use serde::{Deserialize, Serialize};
+
+use crate::config::Config;
+use crate::formatter::Formatter;
+use crate::{FormatError, FormatResult};
+
+/// File extension of Blood sources.
+const BLOOD_EXTENSION: &str = "blood";
+
+/// Directories never descended into when expanding a directory argument.
+const SKIPPED_DIRS: &[&str] = &["target", "build", "node_modules"];
+
+/// Cache file format version. Bump when the file layout changes.
+const CACHE_VERSION: u32 = 1;
+
+/// Formatter output revision, part of every cache key. Bump it in any
+/// change that formats some input differently; the package version is
+/// shared by the whole workspace and rarely changes, so it cannot stand in.
+pub const FORMATTER_REVISION: u32 = 1;
+
+/// Upper bound on remembered entries; older entries are dropped first.
+const MAX_CACHE_ENTRIES: usize = 1 << 16;
+
+/// What to do with each file.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum BatchMode {
+    /// Report files that would be reformatted.
+    Check,
+    /// Rewrite files that are not formatted.
+    Write,
+}
+
+/// Outcome for one file.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum FileStatus {
+    /// Already formatted.
+    Unchanged,
+    /// Skipped: the cache says this exact content is formatted.
+    Cached,
+    /// Not formatted (check mode) or rewritten (write mode).
+    Reformatted,
+}
+
+/// Result for one file, streamed to the caller.
+#[derive(Debug)]
+pub struct FileResult {
+    /// The file.
+    pub path: PathBuf,
+    /// What happened, or why it failed.
+    pub status: FormatResult<FileStatus>,
+}
+
+/// Totals over a batch run.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct BatchSummary {
+    /// Files processed (including cached and failed ones).
+    pub files: usize,
+    /// Files skipped by the cache.
+    pub cached: usize,
+    /// Files that were (or would be) reformatted.
+    pub reformatted: usize,
+    /// Files that could not be read, formatted or written.
+    pub errors: usize,
+}
+
+/// On-disk cache file.
+#[derive(Serialize, Deserialize)]
+struct CacheFile {
+    version: u32,
+    entries: Vec<ContentHash>,
+}
+
+/// Cache of content hashes known to be formatted.
+pub struct FormatCache {
+    /// Where the cache is persisted; `None` disables it.
+    path: Option<PathBuf>,
+    /// Hash of the configuration and formatter revision.
+    config_hash: ContentHash,
+    /// Entries loaded from disk.
+    loaded: HashSet<ContentHash>,
+    /// Entries confirmed during this run.
+    seen: Mutex<HashSet<ContentHash>>,
+    /// Whether `seen` holds anything not in `loaded`.
+    dirty: AtomicBool,
+}
+
+impl FormatCache {
+    /// Opens the cache at its default location (`fmt/formatted.json` in the
+    /// Blood cache directory, `$BLOOD_CACHE` or `~/.blood/cache`).
+    pub fn open(config: &Config) -> Self {
+        let path = BuildCache::default_cache_dir()
+            .join("fmt")
+            .join("formatted.json");
+        Self::at(path, config)
+    }
+
+    /// Opens the cache stored at `path`. A missing or unreadable file
+    /// yields an empty cache.
+    pub fn at(path: PathBuf, config: &Config) -> Self {
+        Self::at_revision(path, config, FORMATTER_REVISION)
+    }
+
+    /// Opens the cache at `path` as a formatter of the given revision would.
+    fn at_revision(path: PathBuf, config: &Config, revision: u32) -> Self {
+        let loaded = fs::read_to_string(&path)
+            .ok()
+            .and_then(|content| serde_json::from_str::<CacheFile>(&content).ok())
+            .filter(|file| file.version == CACHE_VERSION)
+            .map(|file| file.entries.into_iter().collect())
+            .unwrap_or_default();
+        Self {
+            path: Some(path),
+            config_hash: config_hash(config, revision),
+            loaded,
+            seen: Mutex::new(HashSet::new()),
+            dirty: AtomicBool::new(false),
+        }
+    }
+
+    /// A cache that never hits and never persists.
+    pub fn disabled(config: &Config) -> Self {
+        Self {
+            path: None,
+            config_hash: config_hash(config, FORMATTER_REVISION),
+            loaded: HashSet::new(),
+            seen: Mutex::new(HashSet::new()),
+            dirty: AtomicBool::new(false),
+        }
+    }
+
+    /// Cache key for `source` under this cache's configuration.
+    pub fn key(&self, source: &str) -> ContentHash {
+        let mut hasher = ContentHasher::new();
+        hasher.update_hash(&self.config_hash);
+        hasher.update(source.as_bytes());
+        hasher.finalize()
+    }
+
+    /// Whether content with this key is known to be formatted.
+    pub fn contains(&self, key: &ContentHash) -> bool {
+        if self.path.is_none() {
+            return false;
+        }
+        if self.loaded.contains(key) {
+            self.seen
+                .lock()
+                .expect("format cache poisoned")
+                .insert(*key);
+            return true;
+        }
+        self.seen
+            .lock()
+            .expect("format cache poisoned")
+            .contains(key)
+    }
+
+    /// Records that content with this key is formatted.
+    pub fn insert(&self, key: ContentHash) {
+        if self.path.is_none() {
+            return;
+        }
+        let mut seen = self.seen.lock().expect("format cache poisoned");
+        if seen.insert(key) && !self.loaded.contains(&key) {
+            self.dirty.store(true, Ordering::Relaxed);
+        }
+    }
+
+    /// Writes the cache back to disk if anything new was recorded.
+    ///
+    /// Entries seen during this run are kept first; older entries fill the
+    /// remaining room up to [`MAX_CACHE_ENTRIES`].
+    pub fn save(&self) -> io::Result<()> {
+        let Some(path) = &self.path else {
+            return Ok(());
+        };
+        if !self.dirty.load(Ordering::Relaxed) {
+            return Ok(());
+        }
+
+        let seen = self.seen.lock().expect("format cache poisoned");
+        let mut entries: Vec<ContentHash> = seen.iter().copied().collect();
+        let room = MAX_CACHE_ENTRIES.saturating_sub(entries.len());
+        entries.extend(
+            self.loaded
+                .iter()
+                .filter(|key| !seen.contains(key))
+                .take(room)
+                .copied(),
+        );
+        entries.truncate(MAX_CACHE_ENTRIES);
+
+        if let Some(parent) = path.parent() {
+            fs::create_dir_all(parent)?;
+        }
+        let file = CacheFile {
+            version: CACHE_VERSION,
+            entries,
+        };
+        let json = serde_json::to_string(&file).map_err(io::Error::other)?;
+        // Write-then-rename so concurrent runs never see a torn file.
+        let tmp = path.with_extension(format!("json.{}", std::process::id()));
+        fs::write(&tmp, json)?;
+        fs::rename(&tmp, path)
+    }
+}
+
+/// Hash of everything besides file content that affects formatting output.
+fn config_hash(config: &Config, revision: u32) -> ContentHash {
+    let mut hasher = ContentHasher::new();
+    hasher.update_u32(revision);
+    hasher.update_str(&serde_json::to_string(config).unwrap_or_default());
+    hasher.finalize()
+}
+
+/// Expands directory arguments into the Blood files beneath them.
+///
+/// File arguments are kept as given. Hidden directories and build output
+/// directories are skipped. The result is sorted and deduplicated.
+pub fn collect_files(paths: &[PathBuf]) -> io::Result<Vec<PathBuf>> {
+    let mut files = Vec::new();
+    for path in paths {
+        if path.is_dir() {
+            collect_dir(path, &mut files)?;
+        } else {
+            files.push(path.clone());
+        }
+    }
+    files.sort();
+    files.dedup();
+    Ok(files)
+}
+
+fn collect_dir(dir: &Path, files: &mut Vec<PathBuf>) -> io::Result<()> {
+    for entry in fs::read_dir(dir)? {
+        let entry = entry?;
+        let path = entry.path();
+        let name = entry.file_name();
+        let name = name.to_string_lossy();
+        let file_type = entry.file_type()?;
+
+        if file_type.is_dir() {
+            if name.starts_with('.') || SKIPPED_DIRS.contains(&name.as_ref()) {
+                continue;
+            }
+            collect_dir(&path, files)?;
+        } else if path.extension().is_some_and(|ext| ext == BLOOD_EXTENSION) {
+            files.push(path);
+        }
+    }
+    Ok(())
+}
+
+/// Number of worker threads to use when `jobs` is 0.
+pub fn default_jobs() -> usize {
+    std::thread::available_parallelism()
+        .map(|n| n.get())
+        .unwrap_or(1)
+}
+
+/// Processes `files` on `jobs` worker threads (0 = one per core).
+///
+/// `report` is called on the calling thread as each file completes, in
+/// completion order.
+pub fn run(
+    files: &[PathBuf],
+    config: &Config,
+    mode: BatchMode,
+    jobs: usize,
+    cache: &FormatCache,
+    mut report: impl FnMut(&FileResult),
+) -> BatchSummary {
+    let jobs = if jobs == 0 { default_jobs() } else { jobs };
+    let jobs = jobs.clamp(1, files.len().max(1));
+    let next = AtomicUsize::new(0);
+    let (tx, rx) = mpsc::channel::<FileResult>();
+    let mut summary = BatchSummary::default();
+
+    std::thread::scope(|scope| {
+        for _ in 0..jobs {
+            let tx = tx.clone();
+            let next = &next;
+            scope.spawn(move || {
+                let formatter = Formatter::new(config.clone());
+                loop {
+                    let index = next.fetch_add(1, Ordering::Relaxed);
+                    let Some(path) = files.get(index) else {
+                        break;
+                    };
+                    let status = process_file(&formatter, path, mode, cache);
+                    if tx
+                        .send(FileResult {
+                            path: path.clone(),
+                            status,
+                        })
+                        .is_err()
+                    {
+                        break;
+                    }
+                }
+            });
+        }
+        drop(tx);
+
+        for result in rx {
+            summary.files += 1;
+            match &result.status {
+                Ok(FileStatus::Unchanged) => {}
+                Ok(FileStatus::Cached) => summary.cached += 1,
+                Ok(FileStatus::Reformatted) => summary.reformatted += 1,
+                Err(_) => summary.errors += 1,
+            }
+            report(&result);
+        }
+    });
+
+    summary
+}
+
+/// Checks or formats a single file.
+fn process_file(
+    formatter: &Formatter,
+    path: &Path,
+    mode: BatchMode,
+    cache: &FormatCache,
+) -> FormatResult<FileStatus> {
+    let source = fs::read_to_string(path)?;
+    let key = cache.key(&source);
+    if cache.contains(&key) {
+        return Ok(FileStatus::Cached);
+    }
+
+    match mode {
+        BatchMode::Check => {
+            if formatter.check(&source)? {
+                cache.insert(key);
+                Ok(FileStatus::Unchanged)
+            } else {
+                Ok(FileStatus::Reformatted)
+            }
+        }
+        BatchMode::Write => {
+            let formatted = formatter.format(&source)?;
+            if formatted == source {
+                cache.insert(key);
+                return Ok(FileStatus::Unchanged);
+            }
+            fs::write(path, &formatted).map_err(FormatError::IoError)?;
+            // The formatter is not idempotent on every input; only cache
+            // output that a check would accept.
+            if formatter.check(&formatted)? {
+                cache.insert(cache.key(&formatted));
+            }
+            Ok(FileStatus::Reformatted)
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_cache_key_depends_on_config() {
+        let default = Config::default();
+        let mut tabs = Config::default();
+        tabs.use_tabs = true;
+
+        let a = FormatCache::disabled(&default);
+        let b = FormatCache::disabled(&tabs);
+        assert_eq!(a.key("fn main() {}\n"), a.key("fn main() {}\n"));
+        assert_ne!(a.key("fn main() {}\n"), b.key("fn main() {}\n"));
+    }
+
+    #[test]
+    fn test_revision_bump_invalidates_cache() {
+        let path = std::env::temp_dir().join(format!(
+            "blood-fmt-revision-{}.json",
+            std::process::id()
+        ));
+        let config = Config::default();
+        let source = "fn main() {}\n";
+
+        let old = FormatCache::at_revision(path.clone(), &config, 1);
+        let key = old.key(source);
+        old.insert(key);
+        old.save().unwrap();
+
+        let same = FormatCache::at_revision(path.clone(), &config, 1);
+        assert!(same.contains(&same.key(source)));
+        let bumped = FormatCache::at_revision(path.clone(), &config, 2);
+        assert_ne!(bumped.key(source), key);
+        assert!(!bumped.contains(&bumped.key(source)));
+        let _ = fs::remove_file(&path);
+    }
+
+    #[test]
+    fn test_disabled_cache_never_hits() {
+        let cache = FormatCache::disabled(&Config::default());
+        let key = cache.key("fn main() {}\n");
+        cache.insert(key);
+        assert!(!cache.contains(&key));
+    }
+}
@@ -25,6 +25,18 @@ impl Formatter {
         Ok(formatted)
     }
 
+    /// Checks whether `source` is already formatted.
+    ///
+    /// Output is compared against `source` as it is produced and printing
+    /// stops at the first differing byte, so unformatted files are rejected
+    /// without building their formatted text.
+    pub fn check(&self, source: &str) -> FormatResult<bool> {
+        let tokens = self.tokenize(source)?;
+        let mut printer = Printer::checking(&self.config, source);
+        self.print_tokens(&mut printer, &tokens)?;
+        Ok(printer.finish_check())
+    }
+
     /// Tokenizes the source code.
     fn tokenize(&self, source: &str) -> FormatResult<Vec<Token>> {
         let tokenizer = Tokenizer::new(source);
@@ -34,9 +46,15 @@ impl Formatter {
     /// Formats a sequence of tokens.
     fn format_tokens(&self, tokens: &[Token]) -> FormatResult<String> {
         let mut printer = Printer::new(&self.config);
+        self.print_tokens(&mut printer, tokens)?;
+        Ok(printer.finish())
+    }
 
+    /// Prints a sequence of tokens, stopping early if a check-mode printer
+    /// has diverged from its expected text.
+    fn print_tokens(&self, printer: &mut Printer, tokens: &[Token]) -> FormatResult<()> {
         let mut i = 0;
-        while i < tokens.len() {
+        while i < tokens.len() && !printer.diverged() {
             let token = &tokens[i];
 
             match token.kind {
@@ -65,21 +83,21 @@ impl Formatter {
                 }
 
                 TokenKind::Keyword => {
-                    self.format_keyword(&mut printer, token, tokens, &mut i)?;
+                    self.format_keyword(printer, token, tokens, &mut i)?;
                 }
 
                 TokenKind::Identifier => {
                     printer.write(&token.text);
-                    self.maybe_space_after(&mut printer, tokens, i);
+                    self.maybe_space_after(printer, tokens, i);
                 }
 
                 TokenKind::Number | TokenKind::String | TokenKind::Char => {
                     printer.write(&token.text);
-                    self.maybe_space_after(&mut printer, tokens, i);
+                    self.maybe_space_after(printer, tokens, i);
                 }
 
                 TokenKind::Operator => {
-                    self.format_operator(&mut printer, token, tokens, i);
+                    self.format_operator(printer, token, tokens, i);
                 }
 
                 TokenKind::OpenBrace => {
@@ -105,7 +123,7 @@ impl Formatter {
 
                 TokenKind::CloseParen => {
                     printer.write(")");
-                    self.maybe_space_after(&mut printer, tokens, i);
+                    self.maybe_space_after(printer, tokens, i);
                 }
 
                 TokenKind::OpenBracket => {
@@ -114,7 +132,7 @@ impl Formatter {
 
                 TokenKind::CloseBracket => {
                     printer.write("]");
-                    self.maybe_space_after(&mut printer, tokens, i);
+                    self.maybe_space_after(printer, tokens, i);
                 }
 
                 TokenKind::Comma => {
@@ -177,7 +195,7 @@ impl Formatter {
             i += 1;
         }
 
-        Ok(printer.finish())
+        Ok(())
     }
 
     /// Formats a keyword token.
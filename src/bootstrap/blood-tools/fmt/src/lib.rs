@@ -10,6 +10,7 @@
 //! - Handler block formatting
 //! - Comment preservation
 //! - Configurable line width
+//! - Parallel, cached directory mode (see [`batch`])
 //!
 //! # Example
 //!
@@ -22,6 +23,7 @@
 //! assert_eq!(formatted, "fn main() {\n    let x = 1 + 2\n}\n");
 //! ```
 
+pub mod batch;
 pub mod config;
 pub mod formatter;
 pub mod printer;
@@ -65,9 +67,12 @@ pub fn check_formatted(source: &str) -> FormatResult<bool> {
 }
 
 /// Checks if source code is already formatted with the given config.
+///
+/// Stops at the first byte that differs instead of building the full
+/// formatted output.
 pub fn check_formatted_with_config(source: &str, config: &Config) -> FormatResult<bool> {
-    let formatted = format_source_with_config(source, config)?;
-    Ok(source == formatted)
+    let formatter = Formatter::new(config.clone());
+    formatter.check(source)
 }
 
 /// Computes the diff between original and formatted source.
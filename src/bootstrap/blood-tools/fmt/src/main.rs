@@ -1,6 +1,10 @@
 //! Blood Formatter Binary
 //!
 //! Run with: `blood-fmt [OPTIONS] [FILES...]`
+//!
+//! Directories are expanded to the `.blood` files beneath them. With
+//! `--check` or `--write`, files are processed in parallel and results are
+//! printed as they complete.
 
 use std::fs;
 use std::io::{self, Read};
@@ -11,6 +15,7 @@ use clap::{Parser, Subcommand};
 use tracing::{debug, error, info};
 use tracing_subscriber::EnvFilter;
 
+use blood_fmt::batch::{self, BatchMode, FileStatus, FormatCache};
 use blood_fmt::{
     check_formatted_with_config, format_diff_with_config, format_source_with_config, Config,
 };
@@ -23,7 +28,7 @@ struct Cli {
     #[command(subcommand)]
     command: Option<Commands>,
 
-    /// Files to format (reads from stdin if none provided)
+    /// Files or directories to format (reads from stdin if none provided)
     #[arg(value_name = "FILE")]
     files: Vec<PathBuf>,
 
@@ -55,6 +60,14 @@ struct Cli {
     #[arg(short = 'c', long)]
     config: Option<PathBuf>,
 
+    /// Worker threads for --check/--write (0 = one per core)
+    #[arg(short = 'j', long, default_value = "0")]
+    jobs: usize,
+
+    /// Do not consult or update the cache of already-formatted files
+    #[arg(long)]
+    no_cache: bool,
+
     /// Verbose output
     #[arg(short, long)]
     verbose: bool,
@@ -100,11 +113,17 @@ fn main() -> Result<()> {
         return format_stdin(&cli);
     }
 
+    let files = batch::collect_files(&cli.files).context("Failed to expand file arguments")?;
+
+    if cli.check || (cli.write && !cli.diff) {
+        return run_batch(&files, &config, &cli);
+    }
+
     let mut had_errors = false;
     let mut files_checked = 0;
     let mut files_changed = 0;
 
-    for path in &cli.files {
+    for path in &files {
         match process_file(path, &config, &cli) {
             Ok(changed) => {
                 files_checked += 1;
@@ -141,6 +160,58 @@ fn main() -> Result<()> {
     Ok(())
 }
 
+/// Checks or formats `files` in parallel, streaming results as they finish.
+fn run_batch(files: &[PathBuf], config: &Config, cli: &Cli) -> Result<()> {
+    let mode = if cli.check {
+        BatchMode::Check
+    } else {
+        BatchMode::Write
+    };
+    let cache = if cli.no_cache {
+        FormatCache::disabled(config)
+    } else {
+        FormatCache::open(config)
+    };
+
+    let summary = batch::run(
+        files,
+        config,
+        mode,
+        cli.jobs,
+        &cache,
+        |result| match &result.status {
+            Ok(FileStatus::Reformatted) => match mode {
+                BatchMode::Check => println!("{}", result.path.display()),
+                BatchMode::Write => info!("Formatted: {}", result.path.display()),
+            },
+            Ok(FileStatus::Cached) => debug!("Cached: {}", result.path.display()),
+            Ok(FileStatus::Unchanged) => debug!("Unchanged: {}", result.path.display()),
+            Err(e) => error!("Error processing {}: {}", result.path.display(), e),
+        },
+    );
+
+    if let Err(e) = cache.save() {
+        debug!("Failed to save format cache: {}", e);
+    }
+
+    match mode {
+        BatchMode::Check => info!(
+            "Checked {} files ({} cached), {} would be reformatted",
+            summary.files, summary.cached, summary.reformatted
+        ),
+        BatchMode::Write => info!(
+            "Formatted {} files ({} cached), {} changed",
+            summary.files, summary.cached, summary.reformatted
+        ),
+    }
+
+    if summary.errors > 0 || (mode == BatchMode::Check && summary.reformatted > 0) {
+        std::process::exit(1);
+    }
+
+    Ok(())
+}
+
 fn build_config(cli: &Cli) -> Result<Config> {
     let mut config = if let Some(config_path) = &cli.config {
         let content = fs::read_to_string(config_path)
@@ -1,9 +1,21 @@
 //! Pretty Printer
 //!
 //! Handles output formatting with indentation management.
+//!
+//! A printer created with [`Printer::checking`] does not build the full
+//! output. It compares each settled prefix against the expected text and
+//! discards it, and reports [`Printer::diverged`] at the first differing
+//! byte so the caller can stop early.
 
 use crate::config::Config;
 
+/// Bytes at the end of the output that later calls may still rewrite.
+///
+/// Only trailing newlines are ever rewritten (`newline`, `blank_line` and
+/// `finish` inspect at most the last two bytes), so everything before the
+/// trailing newline run, minus this margin, is final.
+const UNSETTLED_TAIL: usize = 2;
+
 /// A pretty printer that manages indentation and output.
 pub struct Printer<'a> {
     config: &'a Config,
@@ -11,6 +23,12 @@ pub struct Printer<'a> {
     indent_level: usize,
     at_line_start: bool,
     last_char: Option<char>,
+    /// Text the output is compared against in check mode.
+    expected: Option<&'a str>,
+    /// Bytes already compared and dropped from `output` (check mode).
+    flushed: usize,
+    /// Whether the output has differed from `expected`.
+    diverged: bool,
 }
 
 impl<'a> Printer<'a> {
@@ -22,9 +40,27 @@ impl<'a> Printer<'a> {
             indent_level: 0,
             at_line_start: true,
             last_char: None,
+            expected: None,
+            flushed: 0,
+            diverged: false,
         }
     }
 
+    /// Creates a printer that compares its output against `expected`
+    /// instead of accumulating it. Finish with [`Printer::finish_check`].
+    pub fn checking(config: &'a Config, expected: &'a str) -> Self {
+        Self {
+            expected: Some(expected),
+            ..Self::new(config)
+        }
+    }
+
+    /// Returns whether the output has already differed from the expected
+    /// text (always false outside check mode).
+    pub fn diverged(&self) -> bool {
+        self.diverged
+    }
+
     /// Writes text to the output.
     pub fn write(&mut self, text: &str) {
         if text.is_empty() {
@@ -39,6 +75,7 @@ impl<'a> Printer<'a> {
 
         self.output.push_str(text);
         self.last_char = text.chars().last();
+        self.settle();
     }
 
     /// Writes a newline.
@@ -48,6 +85,7 @@ impl<'a> Printer<'a> {
             self.output.push('\n');
             self.at_line_start = true;
             self.last_char = Some('\n');
+            self.settle();
         }
     }
 
@@ -98,6 +136,7 @@ impl<'a> Printer<'a> {
             }
             self.at_line_start = true;
             self.last_char = Some('\n');
+            self.settle();
         }
     }
 
@@ -113,18 +152,37 @@ impl<'a> Printer<'a> {
 
     /// Returns the current output length.
     pub fn len(&self) -> usize {
-        self.output.len()
+        self.flushed + self.output.len()
     }
 
     /// Returns whether the output is empty.
     pub fn is_empty(&self) -> bool {
-        self.output.is_empty()
+        self.len() == 0
     }
 
     /// Finishes printing and returns the output.
+    ///
+    /// In check mode the returned string lacks the already compared prefix;
+    /// use [`Printer::finish_check`] there instead.
     pub fn finish(mut self) -> String {
+        self.finish_output();
+        self.output
+    }
+
+    /// Finishes a check-mode printer, returning whether the output is
+    /// identical to the expected text.
+    pub fn finish_check(mut self) -> bool {
+        if self.diverged {
+            return false;
+        }
+        self.finish_output();
+        let expected = self.expected.unwrap_or_default().as_bytes();
+        expected.get(self.flushed..) == Some(self.output.as_bytes())
+    }
+
+    fn finish_output(&mut self) {
         // Ensure file ends with a newline
-        if !self.output.is_empty() && !self.output.ends_with('\n') {
+        if !self.is_empty() && !self.output.ends_with('\n') {
             self.output.push('\n');
         }
 
@@ -132,8 +190,37 @@ impl<'a> Printer<'a> {
         while self.output.ends_with("\n\n") {
             self.output.pop();
         }
+    }
 
-        self.output
+    /// In check mode, compares the settled part of the output against the
+    /// expected text and drops it from the buffer.
+    fn settle(&mut self) {
+        let Some(expected) = self.expected else {
+            return;
+        };
+        if self.diverged {
+            return;
+        }
+
+        let trailing_newlines = self.output.len() - self.output.trim_end_matches('\n').len();
+        let keep = trailing_newlines.max(UNSETTLED_TAIL);
+        let Some(mut cut) = self.output.len().checked_sub(keep) else {
+            return;
+        };
+        while !self.output.is_char_boundary(cut) {
+            cut -= 1;
+        }
+        if cut == 0 {
+            return;
+        }
+
+        let settled = &self.output.as_bytes()[..cut];
+        if expected.as_bytes().get(self.flushed..self.flushed + cut) != Some(settled) {
+            self.diverged = true;
+            return;
+        }
+        self.flushed += cut;
+        self.output.drain(..cut);
     }
 }
 
@@ -160,6 +247,36 @@ mod tests {
         assert!(output.ends_with('\n'));
     }
 
+    #[test]
+    fn test_check_mode_matches_finish() {
+        let config = Config::default();
+        let print = |printer: &mut Printer| {
+            printer.write("fn main()");
+            printer.write(" {");
+            printer.increase_indent();
+            printer.newline();
+            printer.write("42");
+            printer.decrease_indent();
+            printer.newline();
+            printer.blank_line();
+            printer.write("}");
+        };
+
+        let mut printer = Printer::new(&config);
+        print(&mut printer);
+        let expected = printer.finish();
+
+        let mut checker = Printer::checking(&config, &expected);
+        print(&mut checker);
+        assert!(!checker.diverged());
+        assert!(checker.finish_check());
+
+        let mut checker = Printer::checking(&config, "fn other() {}\n");
+        print(&mut checker);
+        assert!(checker.diverged());
+        assert!(!checker.finish_check());
+    }
+
     #[test]
     fn test_indentation() {
         let config = Config::default();
@@ -0,0 +1,1096 @@
+//! In-process JIT evaluation for the REPL.
+//!
+//! A [`JitSession`] owns one LLVM execution engine for the lifetime of the
+//! REPL. The Blood runtime shared library is loaded into the process once;
+//! after that, every definition the user enters is compiled into its own
+//! LLVM module (via [`codegen::compile_definition_to_module`]) and added to
+//! the engine, where it links by symbol name against the runtime and all
+//! previously compiled definitions.
+//!
+//! # Incremental recompilation
+//!
+//! Each input re-runs the front end over the session's definitions, which
+//! are emitted in entry order with the per-input wrapper function last, so
+//! the `DefId`s of existing definitions stay stable between inputs. Modules
+//! are keyed by `DefId` and tagged with the definition's content hash; only
+//! definitions whose hash changed, plus their transitive dependents, are
+//! removed from the engine and recompiled.
+//!
+//! # Evaluation
+//!
+//! An expression is evaluated in two steps. A probe function is type-checked
+//! to learn the type of the value, then a wrapper function returning that
+//! value (widened to `i64`/`u64`/`f64`/`bool`) is compiled and called.
+//!
+//! A wrapper that defines nothing besides itself runs in its own short-lived
+//! engine, linked against the session's symbols, so its code memory is
+//! released once it returns. A wrapper that also defines data or code a
+//! value could point into (string constants, closures, vtables) is added to
+//! the session engine and kept.
+//!
+//! # Bindings
+//!
+//! Each `let` binding lives in a storage slot: a global in its own module,
+//! resident in the session engine. Every wrapper copies the bindings out of
+//! their slots into locals of the same name, and writes the `mut` ones
+//! back after the input has run, so assignments and in-place updates carry
+//! over to later inputs. A binding's initializer runs exactly once. The
+//! slot global has the binding type's LLVM layout and ABI alignment, the
+//! same layout the wrapper's load and store through a `*T` assume.
+//!
+//! # Standard library
+//!
+//! Input is type-checked against the standard library. The stdlib prelude
+//! is parsed once, when the session is created; every later parse starts
+//! from a copy of the interner the prelude was parsed into, so the parsed
+//! prelude can be handed to each type check as is.
+
+use std::collections::{HashMap, HashSet};
+use std::path::{Path, PathBuf};
+use std::sync::Arc;
+use std::time::{Duration, Instant};
+
+use bloodc::codegen::{self, BloodOptLevel, EscapeAnalysisMap, MirBodiesMap};
+use bloodc::content::hash::ContentHasher;
+use bloodc::content::{extract_dependencies, hash_hir_item, ContentHash};
+use bloodc::hir::{self, ConstValue, DefId, PrimitiveTy, TypeKind};
+use bloodc::macro_expand;
+use bloodc::mir::{self, ClosureAnalysisResults, InlineHandlerBodies};
+use bloodc::{ast, Diagnostic};
+use inkwell::context::Context;
+use inkwell::execution_engine::ExecutionEngine;
+use inkwell::module::{Linkage, Module};
+use inkwell::targets::{InitializationConfig, Target};
+use inkwell::OptimizationLevel;
+use string_interner::DefaultStringInterner;
+
+use crate::{ReplError, ReplResult};
+
+/// Virtual path used for content hashing of REPL definitions.
+const REPL_SOURCE_PATH: &str = "<repl>";
+
+/// Name of the local that holds the value of the evaluated input.
+const VALUE_LOCAL: &str = "__repl_value";
+
+/// Names of the Blood runtime shared library, in search order.
+const RUNTIME_DYLIB_NAMES: &[&str] = &[
+    "libblood_runtime.so",    // Linux
+    "libblood_runtime.dylib", // macOS
+    "blood_runtime.dll",      // Windows
+];
+
+/// Optimization level for JIT-compiled definitions.
+///
+/// `Less` keeps compile latency low; REPL definitions are small and the
+/// round trip matters more than peak throughput.
+const JIT_OPT_LEVEL: BloodOptLevel = BloodOptLevel::Less;
+
+/// Input to evaluate against the session's definitions.
+#[derive(Debug, Clone, Copy)]
+pub enum EvalInput<'a> {
+    /// An expression or statement; its value (if any) is reported.
+    Expr(&'a str),
+    /// A `let` statement binding `name`; the bound value is reported.
+    Let {
+        /// The bound variable.
+        name: &'a str,
+        /// The full `let` statement.
+        stmt: &'a str,
+    },
+}
+
+/// Result of evaluating one input.
+#[derive(Debug, Clone)]
+pub struct EvalOutcome {
+    /// Rendered value, or `None` for unit and non-primitive values.
+    pub value: Option<String>,
+    /// Type of the value, as printed by the type checker.
+    pub ty: String,
+    /// Number of definition modules recompiled for this input.
+    pub recompiled: usize,
+    /// Wall-clock time from source to result.
+    pub elapsed: Duration,
+}
+
+/// How a primitive value is returned from the wrapper function.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum ValueRepr {
+    Unit,
+    Signed,
+    Unsigned,
+    Float,
+    Bool,
+    Char,
+    /// Not a primitive: evaluated for effect, only the type is reported.
+    Opaque,
+}
+
+impl ValueRepr {
+    fn of(ty: &hir::Type) -> Self {
+        if ty.is_unit() {
+            return ValueRepr::Unit;
+        }
+        match ty.kind() {
+            TypeKind::Primitive(PrimitiveTy::Int(_)) => ValueRepr::Signed,
+            TypeKind::Primitive(PrimitiveTy::Uint(_)) => ValueRepr::Unsigned,
+            TypeKind::Primitive(PrimitiveTy::Float(_)) => ValueRepr::Float,
+            TypeKind::Primitive(PrimitiveTy::Bool) => ValueRepr::Bool,
+            TypeKind::Primitive(PrimitiveTy::Char) => ValueRepr::Char,
+            _ => ValueRepr::Opaque,
+        }
+    }
+
+    /// Return type and trailing expression of the wrapper function.
+    fn wrapper_tail(self) -> (&'static str, String) {
+        match self {
+            ValueRepr::Signed => (" -> i64", format!("{} as i64", VALUE_LOCAL)),
+            ValueRepr::Unsigned => (" -> u64", format!("{} as u64", VALUE_LOCAL)),
+            ValueRepr::Float => (" -> f64", format!("{} as f64", VALUE_LOCAL)),
+            ValueRepr::Bool => (" -> bool", VALUE_LOCAL.to_string()),
+            ValueRepr::Char => (" -> u32", format!("{} as u32", VALUE_LOCAL)),
+            ValueRepr::Unit | ValueRepr::Opaque => ("", String::new()),
+        }
+    }
+}
+
+/// Output of the front end and MIR pipeline for one REPL source.
+struct Lowered {
+    hir_crate: hir::Crate,
+    mir_bodies: MirBodiesMap,
+    escape_map: EscapeAnalysisMap,
+    inline_handler_bodies: InlineHandlerBodies,
+    closure_analysis: ClosureAnalysisResults,
+    builtin_def_ids: (Option<DefId>, Option<DefId>, Option<DefId>, Option<DefId>),
+}
+
+/// The type-checked probe for one input.
+struct Probe {
+    hir_crate: hir::Crate,
+    builtin_def_ids: (Option<DefId>, Option<DefId>, Option<DefId>, Option<DefId>),
+    /// Type of the input's value.
+    ty: hir::Type,
+    /// Whether the bound variable (for `let` inputs) was declared `mut`.
+    mutable: bool,
+}
+
+/// A definition module resident in the execution engine.
+struct CompiledDef {
+    hash: ContentHash,
+    module: Module<'static>,
+}
+
+/// Storage for one `let` binding, resident in the session engine.
+struct BindingSlot {
+    name: String,
+    /// Source spelling of the binding's type.
+    ty_src: String,
+    mutable: bool,
+    /// Address of the slot's global.
+    addr: usize,
+    module: Module<'static>,
+}
+
+impl BindingSlot {
+    /// Statement copying the binding out of its slot into a local.
+    fn load_stmt(&self) -> String {
+        let kw = if self.mutable { "let mut" } else { "let" };
+        format!(
+            "    {} {}: {} = @unsafe {{ *({}usize as *const {}) }};\n",
+            kw, self.name, self.ty_src, self.addr, self.ty_src
+        )
+    }
+
+    /// Statement copying the local back into the binding's slot.
+    fn store_stmt(&self) -> String {
+        format!(
+            "    @unsafe {{ *({}usize as *mut {}) = {}; }}\n",
+            self.addr, self.ty_src, self.name
+        )
+    }
+}
+
+/// The standard library as seen by every type check in a session.
+struct Stdlib {
+    /// Stdlib root, for `std` imports; `None` if none was found.
+    path: Option<PathBuf>,
+    /// The parsed prelude, if the stdlib has one.
+    prelude: Option<Arc<ast::Program>>,
+    /// Interner holding the prelude's symbols. Each parse starts from a
+    /// clone of it.
+    interner: DefaultStringInterner,
+}
+
+impl Stdlib {
+    /// Find the stdlib and parse its prelude.
+    fn load() -> Self {
+        let path = find_stdlib();
+        let (prelude, interner) = match &path {
+            Some(path) => bloodc::typeck::TypeContext::parse_prelude(
+                path,
+                DefaultStringInterner::default(),
+            ),
+            None => (None, DefaultStringInterner::default()),
+        };
+        Self {
+            path,
+            prelude: prelude.map(Arc::new),
+            interner,
+        }
+    }
+}
+
+/// JIT compilation session backing the REPL.
+pub struct JitSession {
+    context: &'static Context,
+    engine: ExecutionEngine<'static>,
+    /// Definition modules currently in the engine, by `DefId`.
+    compiled: HashMap<DefId, CompiledDef>,
+    /// The handler registration module, tagged with the hash of the
+    /// handler set it registers.
+    handler_registration: Option<CompiledDef>,
+    /// Binding slots in the order the bindings were introduced.
+    bindings: Vec<BindingSlot>,
+    /// Wrapper modules kept in the engine because values may point into
+    /// them (see the module docs).
+    resident_wrappers: Vec<Module<'static>>,
+    /// Counter for unique wrapper function names.
+    eval_count: usize,
+    /// Standard library, loaded once for the session.
+    stdlib: Stdlib,
+}
+
+impl JitSession {
+    /// Create a session: initialize the native target, load the Blood
+    /// runtime into the process and create the execution engine.
+    pub fn new() -> Result<Self, String> {
+        let runtime = find_runtime_dylib().ok_or_else(|| {
+            "Blood runtime shared library not found (set BLOOD_REPL_RUNTIME or build blood-runtime)"
+                .to_string()
+        })?;
+        Self::with_runtime(&runtime)
+    }
+
+    /// Create a session using an explicit runtime shared library.
+    pub fn with_runtime(runtime: &Path) -> Result<Self, String> {
+        Target::initialize_native(&InitializationConfig::default())
+            .map_err(|e| format!("Failed to initialize native target: {}", e))?;
+        ExecutionEngine::link_in_mc_jit();
+
+        // Returns true on failure.
+        if inkwell::support::load_library_permanently(runtime) {
+            return Err(format!(
+                "Failed to load Blood runtime: {}",
+                runtime.display()
+            ));
+        }
+
+        // The context lives as long as the process: modules and the engine
+        // borrow from it for the whole REPL session.
+        let context: &'static Context = Box::leak(Box::new(Context::create()));
+        let root = context.create_module("blood_repl_root");
+        let engine = root
+            .create_jit_execution_engine(OptimizationLevel::Less)
+            .map_err(|e| format!("Failed to create JIT execution engine: {}", e))?;
+
+        Ok(Self {
+            context,
+            engine,
+            compiled: HashMap::new(),
+            handler_registration: None,
+            bindings: Vec::new(),
+            resident_wrappers: Vec::new(),
+            eval_count: 0,
+            stdlib: Stdlib::load(),
+        })
+    }
+
+    /// Type-check and compile `definitions`, replacing any modules whose
+    /// definitions changed. Returns the number of modules recompiled.
+    pub fn define(&mut self, definitions: &str) -> ReplResult<usize> {
+        let lowered = lower(definitions, &self.stdlib)?;
+        self.sync_definitions(&lowered, &HashSet::new())
+    }
+
+    /// Evaluate `input` in the scope of `definitions` and the session's
+    /// bindings.
+    pub fn eval(&mut self, definitions: &str, input: EvalInput<'_>) -> ReplResult<EvalOutcome> {
+        let start = Instant::now();
+        self.eval_count += 1;
+        let n = self.eval_count;
+
+        let mut body = String::new();
+        for slot in &self.bindings {
+            body.push_str(&slot.load_stmt());
+        }
+        match input {
+            EvalInput::Expr(code) => {
+                body.push_str(&format!(
+                    "    let {} = {{ {} }};\n",
+                    VALUE_LOCAL,
+                    code.trim()
+                ));
+            }
+            EvalInput::Let { name, stmt } => {
+                body.push_str(&format!("    {};\n", stmt.trim().trim_end_matches(';')));
+                body.push_str(&format!("    let {} = {};\n", VALUE_LOCAL, name));
+            }
+        }
+
+        // Step 1: type-check a probe to learn the value's type.
+        let probe_name = format!("__repl_probe_{}", n);
+        let probe_src = format!("{}\nfn {}() {{\n{}}}\n", definitions, probe_name, body);
+        let binding = match input {
+            EvalInput::Let { name, .. } => Some(name),
+            EvalInput::Expr(_) => None,
+        };
+        let probe = probe_value(&probe_src, &probe_name, binding, &self.stdlib)?;
+        let repr = ValueRepr::of(&probe.ty);
+
+        // Step 2: allocate the new binding's slot, so the wrapper can store
+        // into it.
+        let new_slot = match binding {
+            Some(name) => Some(self.create_slot(name, &probe, n)?),
+            None => None,
+        };
+
+        // Step 3: compile and run the wrapper. A shadowed binding keeps its
+        // old value; the new one goes to the new slot.
+        for slot in &self.bindings {
+            if slot.mutable && Some(slot.name.as_str()) != binding {
+                body.push_str(&slot.store_stmt());
+            }
+        }
+        if let Some(slot) = &new_slot {
+            body.push_str(&slot.store_stmt());
+        }
+        let wrapper_name = format!("__repl_eval_{}", n);
+        let (ret, tail) = repr.wrapper_tail();
+        let wrapper_src = format!(
+            "{}\nfn {}(){} {{\n{}    {}\n}}\n",
+            definitions, wrapper_name, ret, body, tail
+        );
+        let (value, recompiled) = match self.run_wrapper(&wrapper_src, &wrapper_name, repr) {
+            Ok(result) => result,
+            Err(e) => {
+                if let Some(slot) = new_slot {
+                    self.release_slot(slot);
+                }
+                return Err(e);
+            }
+        };
+
+        if let Some(slot) = new_slot {
+            if let Some(pos) = self.bindings.iter().position(|b| b.name == slot.name) {
+                let old = self.bindings.remove(pos);
+                self.release_slot(old);
+            }
+            self.bindings.push(slot);
+        }
+
+        Ok(EvalOutcome {
+            value,
+            ty: probe.ty.to_string(),
+            recompiled,
+            elapsed: start.elapsed(),
+        })
+    }
+
+    /// Number of definition modules currently resident in the engine.
+    pub fn resident_modules(&self) -> usize {
+        self.compiled.len() + usize::from(self.handler_registration.is_some())
+    }
+
+    /// Drop every definition module and binding (`:clear`).
+    pub fn reset(&mut self) {
+        for (_, def) in self.compiled.drain() {
+            let _ = self.engine.remove_module(&def.module);
+        }
+        if let Some(reg) = self.handler_registration.take() {
+            let _ = self.engine.remove_module(&reg.module);
+        }
+        for slot in std::mem::take(&mut self.bindings) {
+            let _ = self.engine.remove_module(&slot.module);
+        }
+        for module in self.resident_wrappers.drain(..) {
+            let _ = self.engine.remove_module(&module);
+        }
+    }
+
+    /// Allocate the storage slot for binding `name` of the probed type.
+    fn create_slot(&mut self, name: &str, probe: &Probe, n: usize) -> ReplResult<BindingSlot> {
+        let ty_src = type_source(&probe.ty, &probe.hir_crate).ok_or_else(|| {
+            ReplError::EvalError(format!(
+                "`{}` has type {}, which cannot be kept across inputs",
+                name, probe.ty
+            ))
+        })?;
+        let symbol = format!("__repl_slot_{}", n);
+        let module = codegen::compile_storage_slot_to_module(
+            self.context,
+            &probe.hir_crate,
+            probe.builtin_def_ids,
+            &probe.ty,
+            &symbol,
+        )
+        .map_err(diagnostics_to_eval_error)?;
+        self.engine
+            .add_module(&module)
+            .map_err(|()| ReplError::EvalError(format!("slot `{}` already in engine", symbol)))?;
+        let addr = match self.engine.get_function_address(&symbol) {
+            Ok(addr) => addr,
+            Err(e) => {
+                let _ = self.engine.remove_module(&module);
+                return Err(ReplError::EvalError(format!(
+                    "cannot resolve `{}`: {:?}",
+                    symbol, e
+                )));
+            }
+        };
+        // Loads and stores through `*T` assume the slot is aligned for `T`,
+        // which matters once `T` is an aggregate wider than a word.
+        let align = module.get_global(&symbol).map_or(0, |g| g.get_alignment()) as usize;
+        if align == 0 || addr % align != 0 {
+            let _ = self.engine.remove_module(&module);
+            return Err(ReplError::EvalError(format!(
+                "slot for `{}` at {:#x} is not aligned for {}",
+                name, addr, ty_src
+            )));
+        }
+        Ok(BindingSlot {
+            name: name.to_string(),
+            ty_src,
+            mutable: probe.mutable,
+            addr,
+            module,
+        })
+    }
+
+    fn release_slot(&mut self, slot: BindingSlot) {
+        let _ = self.engine.remove_module(&slot.module);
+    }
+
+    /// Lower and compile the wrapper, bring the definitions up to date and
+    /// call it. Returns the rendered value and the number of definition
+    /// modules recompiled.
+    fn run_wrapper(
+        &mut self,
+        wrapper_src: &str,
+        wrapper_name: &str,
+        repr: ValueRepr,
+    ) -> ReplResult<(Option<String>, usize)> {
+        let lowered = lower(wrapper_src, &self.stdlib)?;
+        let wrapper_id = find_fn(&lowered.hir_crate, wrapper_name).ok_or_else(|| {
+            ReplError::EvalError(format!("wrapper `{}` missing after lowering", wrapper_name))
+        })?;
+
+        let mut skip = HashSet::new();
+        skip.insert(wrapper_id);
+        let recompiled = self.sync_definitions(&lowered, &skip)?;
+
+        let module = self.compile_def(&lowered, wrapper_id)?;
+        let symbol = mangled_symbol(&module, wrapper_name).unwrap_or(wrapper_name.to_string());
+
+        let value = match self.session_links(&module, &symbol) {
+            Some(links) => {
+                // Nothing can point into the module once the wrapper
+                // returns: run it in its own engine, which frees the code
+                // when it is dropped at the end of this arm.
+                let engine = module
+                    .create_jit_execution_engine(OptimizationLevel::Less)
+                    .map_err(|e| {
+                        ReplError::EvalError(format!("Failed to create wrapper engine: {}", e))
+                    })?;
+                for (name, addr) in links {
+                    if let Some(f) = module.get_function(&name) {
+                        engine.add_global_mapping(&f, addr);
+                    } else if let Some(g) = module.get_global(&name) {
+                        engine.add_global_mapping(&g.as_pointer_value(), addr);
+                    }
+                }
+                unsafe { call_wrapper(&engine, &symbol, repr) }
+            }
+            None => {
+                self.engine.add_module(&module).map_err(|()| {
+                    ReplError::EvalError("wrapper module already in engine".to_string())
+                })?;
+                let value = unsafe { call_wrapper(&self.engine, &symbol, repr) };
+                self.resident_wrappers.push(module);
+                value
+            }
+        };
+        Ok((value?, recompiled))
+    }
+
+    /// Session-engine addresses for the symbols the wrapper module
+    /// declares or carries link-once copies of.
+    ///
+    /// Returns `None` if the module defines anything besides the wrapper
+    /// `symbol` that the session does not already hold (string constants,
+    /// closures, vtables, the only copy of a static): the wrapper's result
+    /// may point into those, so the module must stay resident.
+    fn session_links(
+        &self,
+        module: &Module<'static>,
+        symbol: &str,
+    ) -> Option<Vec<(String, usize)>> {
+        let link_once = |linkage: Linkage| {
+            matches!(
+                linkage,
+                Linkage::LinkOnceAny | Linkage::LinkOnceODR | Linkage::WeakAny | Linkage::WeakODR
+            )
+        };
+        let mut links = Vec::new();
+        let mut resolve = |name: String, defined: bool, shareable: bool| -> Option<()> {
+            if name == symbol || name.starts_with("llvm.") {
+                return Some(());
+            }
+            if defined && !shareable {
+                return None;
+            }
+            match self.engine.get_function_address(&name) {
+                Ok(addr) => links.push((name, addr)),
+                // Unresolved declarations are left to the process symbol
+                // table; an unused one never needs resolving.
+                Err(_) if defined => return None,
+                Err(_) => {}
+            }
+            Some(())
+        };
+
+        for f in module.get_functions() {
+            let name = f.get_name().to_string_lossy().into_owned();
+            resolve(name, f.count_basic_blocks() > 0, link_once(f.get_linkage()))?;
+        }
+        for g in module.get_globals() {
+            let name = g.get_name().to_string_lossy().into_owned();
+            resolve(
+                name,
+                g.get_initializer().is_some(),
+                link_once(g.get_linkage()),
+            )?;
+        }
+        Some(links)
+    }
+
+    /// Bring the engine in line with `lowered`: recompile definitions whose
+    /// content hash changed (and their dependents) and drop stale ones.
+    fn sync_definitions(&mut self, lowered: &Lowered, skip: &HashSet<DefId>) -> ReplResult<usize> {
+        let hashes = definition_hashes(lowered, skip);
+
+        let mut dirty: HashSet<DefId> = hashes
+            .iter()
+            .filter(|&(id, hash)| self.compiled.get(id).map(|c| c.hash) != Some(*hash))
+            .map(|(&id, _)| id)
+            .collect();
+
+        // Propagate to dependents: a caller's code bakes in the callee's
+        // signature and layout, which its own hash does not cover.
+        let mut dependents: HashMap<DefId, Vec<DefId>> = HashMap::new();
+        for (&def_id, item) in &lowered.hir_crate.items {
+            if skip.contains(&def_id) {
+                continue;
+            }
+            for dep in extract_dependencies(item, &lowered.hir_crate.bodies) {
+                dependents.entry(dep).or_default().push(def_id);
+            }
+        }
+        let mut work: Vec<DefId> = dirty.iter().copied().collect();
+        while let Some(id) = work.pop() {
+            for &user in dependents.get(&id).into_iter().flatten() {
+                if hashes.contains_key(&user) && dirty.insert(user) {
+                    work.push(user);
+                }
+            }
+        }
+
+        // Remove stale and dirty modules before adding replacements so the
+        // engine never holds two definitions of one symbol.
+        let stale: Vec<DefId> = self
+            .compiled
+            .keys()
+            .filter(|id| !hashes.contains_key(id) || dirty.contains(id))
+            .copied()
+            .collect();
+        for id in stale {
+            if let Some(def) = self.compiled.remove(&id) {
+                let _ = self.engine.remove_module(&def.module);
+            }
+        }
+
+        let mut order: Vec<DefId> = dirty.into_iter().collect();
+        order.sort_by_key(|id| id.index());
+        for &def_id in &order {
+            let module = self.compile_def(lowered, def_id)?;
+            self.engine.add_module(&module).map_err(|()| {
+                ReplError::EvalError(format!("module for {:?} already in engine", def_id))
+            })?;
+            self.compiled.insert(
+                def_id,
+                CompiledDef {
+                    hash: hashes[&def_id],
+                    module,
+                },
+            );
+        }
+
+        self.sync_handler_registration(lowered, &hashes)?;
+        Ok(order.len())
+    }
+
+    /// Re-register handlers when the set of handler definitions changed.
+    fn sync_handler_registration(
+        &mut self,
+        lowered: &Lowered,
+        hashes: &HashMap<DefId, ContentHash>,
+    ) -> ReplResult<()> {
+        let mut handlers: Vec<DefId> = lowered
+            .hir_crate
+            .items
+            .iter()
+            .filter(|(_, item)| matches!(item.kind, hir::ItemKind::Handler { .. }))
+            .map(|(&id, _)| id)
+            .collect();
+        if handlers.is_empty() {
+            return Ok(());
+        }
+        handlers.sort_by_key(|id| id.index());
+
+        let mut hasher = ContentHasher::new();
+        for id in &handlers {
+            hasher.update_u32(id.index());
+            if let Some(hash) = hashes.get(id) {
+                hasher.update_hash(hash);
+            }
+        }
+        let set_hash = hasher.finalize();
+        if self.handler_registration.as_ref().map(|r| r.hash) == Some(set_hash) {
+            return Ok(());
+        }
+
+        if let Some(old) = self.handler_registration.take() {
+            let _ = self.engine.remove_module(&old.module);
+        }
+        let module = codegen::compile_handler_registration_to_module(
+            self.context,
+            &lowered.hir_crate,
+            lowered.builtin_def_ids,
+        )
+        .map_err(diagnostics_to_eval_error)?;
+        self.engine
+            .add_module(&module)
+            .map_err(|()| ReplError::EvalError("handler registration already in engine".into()))?;
+
+        // Call the registration constructor directly rather than through
+        // run_static_constructors, which would re-run every module's ctors.
+        unsafe {
+            if let Ok(register) = self
+                .engine
+                .get_function::<unsafe extern "C" fn()>("__blood_register_handlers")
+            {
+                register.call();
+            }
+        }
+        self.handler_registration = Some(CompiledDef {
+            hash: set_hash,
+            module,
+        });
+        Ok(())
+    }
+
+    /// Compile one definition into a fresh module in the session context.
+    fn compile_def(&self, lowered: &Lowered, def_id: DefId) -> ReplResult<Module<'static>> {
+        codegen::compile_definition_to_module(
+            self.context,
+            def_id,
+            &lowered.hir_crate,
+            lowered.mir_bodies.get(&def_id),
+            lowered.escape_map.get(&def_id),
+            Some(&lowered.mir_bodies),
+            Some(&lowered.inline_handler_bodies),
+            lowered.builtin_def_ids,
+            Some(&lowered.closure_analysis),
+            JIT_OPT_LEVEL,
+            None,
+        )
+        .map_err(diagnostics_to_eval_error)
+    }
+}
+
+/// Look up and call the wrapper, rendering its result.
+unsafe fn call_wrapper(
+    engine: &ExecutionEngine<'static>,
+    symbol: &str,
+    repr: ValueRepr,
+) -> ReplResult<Option<String>> {
+    let missing = |e| ReplError::EvalError(format!("cannot resolve `{}`: {:?}", symbol, e));
+    Ok(match repr {
+        ValueRepr::Signed => {
+            let f = engine.get_function::<unsafe extern "C" fn() -> i64>(symbol);
+            Some(f.map_err(missing)?.call().to_string())
+        }
+        ValueRepr::Unsigned => {
+            let f = engine.get_function::<unsafe extern "C" fn() -> u64>(symbol);
+            Some(f.map_err(missing)?.call().to_string())
+        }
+        ValueRepr::Float => {
+            let f = engine.get_function::<unsafe extern "C" fn() -> f64>(symbol);
+            Some(format!("{:?}", f.map_err(missing)?.call()))
+        }
+        ValueRepr::Bool => {
+            let f = engine.get_function::<unsafe extern "C" fn() -> bool>(symbol);
+            Some(f.map_err(missing)?.call().to_string())
+        }
+        ValueRepr::Char => {
+            let f = engine.get_function::<unsafe extern "C" fn() -> u32>(symbol);
+            let c = f.map_err(missing)?.call();
+            Some(format!(
+                "{:?}",
+                char::from_u32(c).unwrap_or(char::REPLACEMENT_CHARACTER)
+            ))
+        }
+        ValueRepr::Unit | ValueRepr::Opaque => {
+            let f = engine.get_function::<unsafe extern "C" fn()>(symbol);
+            f.map_err(missing)?.call();
+            None
+        }
+    })
+}
+
+impl Drop for JitSession {
+    fn drop(&mut self) {
+        // Modules must leave the engine before it is disposed.
+        self.reset();
+    }
+}
+
+/// Content hash for every compilable definition in `lowered`.
+///
+/// Top-level items use the build cache's HIR hash. Bodies without a
+/// top-level item (methods, closures) are hashed from their MIR.
+fn definition_hashes(lowered: &Lowered, skip: &HashSet<DefId>) -> HashMap<DefId, ContentHash> {
+    let path = Path::new(REPL_SOURCE_PATH);
+    let hir = &lowered.hir_crate;
+    let mut hashes = HashMap::new();
+
+    for (&def_id, body) in &lowered.mir_bodies {
+        if skip.contains(&def_id) {
+            continue;
+        }
+        let hash = match hir.items.get(&def_id) {
+            Some(item) => hash_hir_item(def_id, item, &hir.bodies, &hir.items, Some(path)),
+            None => {
+                let mut hasher = ContentHasher::new();
+                hasher.update_u32(def_id.index());
+                hasher.update_str(&format!("{:?}", body));
+                hasher.finalize()
+            }
+        };
+        hashes.insert(def_id, hash);
+    }
+    for (&def_id, item) in &hir.items {
+        if skip.contains(&def_id) || hashes.contains_key(&def_id) {
+            continue;
+        }
+        if matches!(item.kind, hir::ItemKind::Handler { .. }) {
+            hashes.insert(
+                def_id,
+                hash_hir_item(def_id, item, &hir.bodies, &hir.items, Some(path)),
+            );
+        }
+    }
+    hashes
+}
+
+/// Parse, macro-expand and type-check `source` against `stdlib`.
+fn check<'a>(source: &'a str, stdlib: &Stdlib) -> ReplResult<bloodc::typeck::TypeContext<'a>> {
+    let mut parser = bloodc::Parser::with_interner(source, stdlib.interner.clone());
+    let mut program = parser
+        .parse_program()
+        .map_err(|errs| ReplError::ParseError(join_diagnostics(&errs)))?;
+    let interner = parser.take_interner();
+
+    let mut expander = macro_expand::MacroExpander::with_source(interner, source);
+    let macro_errors = expander.expand_program(&mut program);
+    if !macro_errors.is_empty() {
+        return Err(ReplError::ParseError(join_diagnostics(&macro_errors)));
+    }
+    let interner = expander.into_interner();
+
+    let mut ctx =
+        bloodc::typeck::TypeContext::new(source, interner).with_source_path(REPL_SOURCE_PATH);
+    if let Some(path) = &stdlib.path {
+        ctx = ctx.with_stdlib_path(path);
+    }
+    if let Some(prelude) = &stdlib.prelude {
+        ctx = ctx.with_prelude(Arc::clone(prelude));
+    }
+
+    let mut errors: Vec<Diagnostic> = Vec::new();
+    let resolve_ok = match ctx.resolve_program(&program) {
+        Ok(()) => true,
+        Err(errs) => {
+            errors.extend(errs);
+            false
+        }
+    };
+    ctx.detect_deref_traits();
+    ctx.expand_derives();
+    if let Err(errs) = ctx.check_recursive_types() {
+        errors.extend(errs);
+    }
+    if resolve_ok {
+        if let Err(errs) = ctx.check_all_bodies() {
+            errors.extend(errs);
+        }
+    }
+    if !errors.is_empty() {
+        return Err(ReplError::TypeError(join_diagnostics(&errors)));
+    }
+    Ok(ctx)
+}
+
+/// Run the full pipeline up to (but not including) codegen.
+fn lower(source: &str, stdlib: &Stdlib) -> ReplResult<Lowered> {
+    let ctx = check(source, stdlib)?;
+    let builtin_def_ids = ctx.get_builtin_def_ids();
+    let type_name_map = ctx.build_type_name_map();
+    let mut hir_crate = ctx.into_hir();
+
+    let linearity_errors = bloodc::typeck::linearity::check_crate_linearity(&hir_crate);
+    if !linearity_errors.is_empty() {
+        let diags: Vec<Diagnostic> = linearity_errors
+            .iter()
+            .map(|e| e.to_diagnostic_with_names(&type_name_map))
+            .collect();
+        return Err(ReplError::TypeError(join_diagnostics(&diags)));
+    }
+    bloodc::expand::expand_macros(&mut hir_crate).map_err(diagnostics_to_eval_error)?;
+
+    let (mut mir_bodies, inline_handler_bodies) = {
+        let mut lowering = mir::MirLowering::new(&hir_crate);
+        lowering.lower_crate().map_err(diagnostics_to_eval_error)?
+    };
+    for body in mir_bodies.values_mut() {
+        mir::safepoint::insert_safepoints(body, false);
+    }
+
+    let adt_fields = |def_id: DefId| -> Option<Vec<hir::Type>> {
+        let item = hir_crate.items.get(&def_id)?;
+        let field_tys = |kind: &hir::StructKind| match kind {
+            hir::StructKind::Record(fields) | hir::StructKind::Tuple(fields) => {
+                fields.iter().map(|f| f.ty.clone()).collect()
+            }
+            hir::StructKind::Unit => Vec::new(),
+        };
+        match &item.kind {
+            hir::ItemKind::Struct(def) => Some(field_tys(&def.kind)),
+            hir::ItemKind::Enum(def) => Some(
+                def.variants
+                    .iter()
+                    .flat_map(|v| field_tys(&v.fields))
+                    .collect(),
+            ),
+            _ => None,
+        }
+    };
+    let escape_map: EscapeAnalysisMap = mir_bodies
+        .iter()
+        .map(|(&def_id, body)| {
+            let mut analyzer = mir::EscapeAnalyzer::new();
+            (def_id, analyzer.analyze_with_adt_lookup(body, &adt_fields))
+        })
+        .collect();
+    let closure_analysis = mir::ClosureAnalyzer::new().analyze_bodies(&mir_bodies);
+
+    Ok(Lowered {
+        hir_crate,
+        mir_bodies,
+        escape_map,
+        inline_handler_bodies,
+        closure_analysis,
+        builtin_def_ids,
+    })
+}
+
+/// Type-check `source` and find the type of the probe's value local,
+/// plus whether `binding` (if any) was declared `mut`.
+fn probe_value(
+    source: &str,
+    probe_name: &str,
+    binding: Option<&str>,
+    stdlib: &Stdlib,
+) -> ReplResult<Probe> {
+    let ctx = check(source, stdlib)?;
+    let builtin_def_ids = ctx.get_builtin_def_ids();
+    let hir_crate = ctx.into_hir();
+    let body = find_fn(&hir_crate, probe_name)
+        .and_then(|id| match &hir_crate.items[&id].kind {
+            hir::ItemKind::Fn(def) => def.body_id,
+            _ => None,
+        })
+        .and_then(|body_id| hir_crate.bodies.get(&body_id))
+        .ok_or_else(|| ReplError::TypeError(format!("probe `{}` has no body", probe_name)))?;
+    let find_local = |name: &str| {
+        body.locals
+            .iter()
+            .rev()
+            .find(|l| l.name.as_deref() == Some(name))
+    };
+    let value = find_local(VALUE_LOCAL)
+        .ok_or_else(|| ReplError::TypeError("could not infer the type of the input".into()))?;
+    let ty = value.ty.clone();
+    let mutable = binding
+        .and_then(find_local)
+        .map(|l| l.mutable)
+        .unwrap_or(false);
+    Ok(Probe {
+        hir_crate,
+        builtin_def_ids,
+        ty,
+        mutable,
+    })
+}
+
+/// Find a top-level function by name.
+fn find_fn(hir_crate: &hir::Crate, name: &str) -> Option<DefId> {
+    hir_crate
+        .items
+        .iter()
+        .find(|(_, item)| item.name == name && matches!(item.kind, hir::ItemKind::Fn(_)))
+        .map(|(&id, _)| id)
+}
+
+/// Resolve the emitted symbol for `name` in `module`.
+///
+/// Function symbols are path-mangled (`blood$<path>`); pick the defined
+/// function whose mangled name ends with the wrapper name.
+fn mangled_symbol(module: &Module<'_>, name: &str) -> Option<String> {
+    let suffix = format!("${}", name);
+    module
+        .get_functions()
+        .filter(|f| f.count_basic_blocks() > 0)
+        .map(|f| f.get_name().to_string_lossy().into_owned())
+        .find(|sym| sym == name || sym.ends_with(&suffix))
+}
+
+/// Spell `ty` as Blood source, for the annotations on binding loads and
+/// stores.
+///
+/// `None` for types that cannot be named (closures, inference variables)
+/// and for borrows other than `&str`, which would outlive the wrapper frame
+/// they point into.
+fn type_source(ty: &hir::Type, hir_crate: &hir::Crate) -> Option<String> {
+    let list = |tys: &[hir::Type]| -> Option<Vec<String>> {
+        tys.iter().map(|t| type_source(t, hir_crate)).collect()
+    };
+    match ty.kind() {
+        TypeKind::Primitive(PrimitiveTy::Str | PrimitiveTy::Never) => None,
+        TypeKind::Primitive(_) => Some(ty.to_string()),
+        TypeKind::Tuple(elems) => {
+            let parts = list(elems)?;
+            Some(match parts.len() {
+                1 => format!("({},)", parts[0]),
+                _ => format!("({})", parts.join(", ")),
+            })
+        }
+        TypeKind::Array { element, size } => {
+            let len = match size {
+                ConstValue::Int(n) => n.to_string(),
+                ConstValue::Uint(n) => n.to_string(),
+                _ => return None,
+            };
+            Some(format!("[{}; {}]", type_source(element, hir_crate)?, len))
+        }
+        TypeKind::Ref {
+            inner,
+            mutable: false,
+        } if matches!(inner.kind(), TypeKind::Primitive(PrimitiveTy::Str)) => {
+            Some("&str".to_string())
+        }
+        TypeKind::Ptr { inner, mutable } => Some(format!(
+            "*{} {}",
+            if *mutable { "mut" } else { "const" },
+            type_source(inner, hir_crate)?
+        )),
+        TypeKind::Adt { def_id, args } => {
+            let name = &hir_crate.items.get(def_id)?.name;
+            if args.is_empty() {
+                Some(name.clone())
+            } else {
+                Some(format!("{}<{}>", name, list(args)?.join(", ")))
+            }
+        }
+        _ => None,
+    }
+}
+
+/// Collapse diagnostics into one message.
+fn join_diagnostics(diags: &[Diagnostic]) -> String {
+    diags
+        .iter()
+        .map(|d| d.message.clone())
+        .collect::<Vec<_>>()
+        .join("\n")
+}
+
+fn diagnostics_to_eval_error(diags: Vec<Diagnostic>) -> ReplError {
+    ReplError::EvalError(join_diagnostics(&diags))
+}
+
+/// Locate the Blood runtime shared library.
+///
+/// Mirrors `bloodc`'s runtime search: environment override, then next to
+/// the executable, then the bootstrap workspace's `target/` directories,
+/// then the installed toolchain.
+fn find_runtime_dylib() -> Option<PathBuf> {
+    if let Ok(path) = std::env::var("BLOOD_REPL_RUNTIME") {
+        let p = PathBuf::from(path);
+        if p.exists() {
+            return Some(p);
+        }
+    }
+
+    let mut dirs: Vec<PathBuf> = Vec::new();
+    if let Ok(exe_path) = std::env::current_exe() {
+        if let Some(exe_dir) = exe_path.parent() {
+            dirs.push(exe_dir.to_path_buf());
+            // blood-tools/target/<profile>/ -> src/bootstrap/target/<profile>/
+            for profile in ["release", "debug"] {
+                dirs.push(exe_dir.join("../../../target").join(profile));
+                dirs.push(exe_dir.join("../../../../target").join(profile));
+            }
+        }
+    }
+    if let Some(home) = std::env::var_os("HOME") {
+        dirs.push(PathBuf::from(home).join(".blood/lib"));
+    }
+
+    dirs.iter()
+        .flat_map(|dir| RUNTIME_DYLIB_NAMES.iter().map(move |name| dir.join(name)))
+        .find(|p| p.exists())
+}
+
+/// Locate the standard library, as `bloodc` does: `BLOOD_STDLIB_PATH`,
+/// then the installed toolchain.
+fn find_stdlib() -> Option<PathBuf> {
+    if let Ok(path) = std::env::var("BLOOD_STDLIB_PATH") {
+        let p = PathBuf::from(path);
+        if p.exists() {
+            return Some(p);
+        }
+    }
+    let installed = PathBuf::from(std::env::var_os("HOME")?).join(".blood/lib/stdlib");
+    installed.exists().then_some(installed)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_wrapper_tail_widens_primitives() {
+        assert_eq!(ValueRepr::Signed.wrapper_tail().0, " -> i64");
+        assert_eq!(ValueRepr::Float.wrapper_tail().1, "__repl_value as f64");
+        assert_eq!(ValueRepr::Unit.wrapper_tail(), ("", String::new()));
+    }
+}
@@ -3,21 +3,28 @@
 //! The REPL provides an interactive way to explore the Blood language,
 //! test expressions, and learn about types and effects.
 //!
-//! # Design Decision: Parse-Only Mode
+//! # Evaluation
 //!
-//! The REPL operates in **parse-only mode** by design. Expressions are parsed
-//! and validated but not evaluated. Full evaluation requires JIT pipeline
-//! integration, which is a self-hosted compiler concern. Use `blood run <file>`
-//! to execute Blood programs.
+//! Input is evaluated in-process by a [`jit::JitSession`]: each definition is
+//! compiled into its own LLVM module and linked into a long-lived execution
+//! engine together with the Blood runtime, so state persists across inputs
+//! and only changed definitions are recompiled. See the [`jit`] module for
+//! details.
+//!
+//! When the Blood runtime shared library cannot be found, the session falls
+//! back to **parse-only mode**: expressions are parsed and validated but not
+//! evaluated. Use `blood run <file>` to execute Blood programs in that case.
 //!
 //! # Features
 //!
-//! - Expression parsing and validation
-//! - Variable binding tracking (parse-only)
+//! - Expression evaluation with typed results
+//! - Variable binding tracking across inputs
 //! - Special commands (`:help`, `:type`, `:clear`, `:quit`)
 //! - Type information display
 //! - Parse and type error feedback
 
+pub mod jit;
+
 use std::collections::HashMap;
 use std::io;
 
@@ -25,6 +32,8 @@ use bloodc::Parser;
 use colored::Colorize;
 use thiserror::Error;
 
+use crate::jit::{EvalInput, JitSession};
+
 /// REPL errors.
 #[derive(Error, Debug)]
 pub enum ReplError {
@@ -117,12 +126,21 @@ pub struct Definition {
 pub struct ReplSession {
     /// Variable bindings.
     bindings: HashMap<String, Binding>,
+    /// Binding names in the order they were introduced.
+    binding_order: Vec<String>,
     /// Definitions (types, effects, functions, handlers).
     definitions: HashMap<String, Definition>,
+    /// Definition names in entry order. Redefinitions keep their slot so
+    /// that the JIT sees stable `DefId`s for everything else.
+    definition_order: Vec<String>,
     /// Line counter.
     line_count: usize,
     /// Whether to show types after evaluation.
     show_types: bool,
+    /// JIT backend, created on first use.
+    jit: Option<JitSession>,
+    /// Why the JIT is unavailable, once creating it has failed.
+    jit_error: Option<String>,
 }
 
 impl ReplSession {
@@ -130,12 +148,37 @@ impl ReplSession {
     pub fn new() -> Self {
         Self {
             bindings: HashMap::new(),
+            binding_order: Vec::new(),
             definitions: HashMap::new(),
+            definition_order: Vec::new(),
             line_count: 0,
             show_types: true,
+            jit: None,
+            jit_error: None,
         }
     }
 
+    /// The JIT backend, or `None` in parse-only mode.
+    fn jit(&mut self) -> Option<&mut JitSession> {
+        if self.jit.is_none() && self.jit_error.is_none() {
+            match JitSession::new() {
+                Ok(jit) => self.jit = Some(jit),
+                Err(e) => self.jit_error = Some(e),
+            }
+        }
+        self.jit.as_mut()
+    }
+
+    /// Whether inputs are evaluated (as opposed to parse-only mode).
+    pub fn is_evaluating(&mut self) -> bool {
+        self.jit().is_some()
+    }
+
+    /// Why the session is in parse-only mode, if it is.
+    pub fn jit_unavailable_reason(&self) -> Option<&str> {
+        self.jit_error.as_deref()
+    }
+
     /// Execute a command and return the output.
     pub fn execute(&mut self, input: &str) -> ReplResult<String> {
         let command = Command::parse(input);
@@ -233,7 +276,7 @@ impl ReplSession {
                             continue;
                         };
 
-                        self.definitions.insert(name.clone(), Definition {
+                        self.insert_definition(Definition {
                             name: name.clone(),
                             kind: kind.to_string(),
                             source: trimmed.to_string(),
@@ -303,8 +346,58 @@ impl ReplSession {
     /// Clear all bindings.
     fn clear(&mut self) {
         self.bindings.clear();
+        self.binding_order.clear();
         self.definitions.clear();
+        self.definition_order.clear();
         self.line_count = 0;
+        if let Some(jit) = self.jit.as_mut() {
+            jit.reset();
+        }
+    }
+
+    /// Record a definition, keeping the slot of an earlier one of the same name.
+    fn insert_definition(&mut self, def: Definition) {
+        if !self.definitions.contains_key(&def.name) {
+            self.definition_order.push(def.name.clone());
+        }
+        self.definitions.insert(def.name.clone(), def);
+    }
+
+    /// Record a binding, keeping the slot of an earlier one of the same name.
+    fn insert_binding(&mut self, binding: Binding) {
+        if !self.bindings.contains_key(&binding.name) {
+            self.binding_order.push(binding.name.clone());
+        }
+        self.bindings.insert(binding.name.clone(), binding);
+    }
+
+    /// All definitions in entry order, with `replace` substituted for the
+    /// definition of the same name (or appended if new).
+    fn definitions_source(&self, replace: Option<(&str, &str)>) -> String {
+        let mut source = String::new();
+        for name in &self.definition_order {
+            let def_source = match replace {
+                Some((r, code)) if r == name => code,
+                _ => self.definitions[name].source.as_str(),
+            };
+            source.push_str(def_source);
+            source.push('\n');
+        }
+        if let Some((r, code)) = replace {
+            if !self.definitions.contains_key(r) {
+                source.push_str(code);
+                source.push('\n');
+            }
+        }
+        source
+    }
+
+    /// Binding replay statements in the order they were introduced.
+    fn binding_sources(&self) -> Vec<String> {
+        self.binding_order
+            .iter()
+            .map(|name| self.bindings[name].source.clone())
+            .collect()
     }
 
     /// Evaluate Blood code.
@@ -366,7 +459,14 @@ impl ReplSession {
                         "unknown"
                     };
 
-                    self.definitions.insert(name.clone(), Definition {
+                    // Type-check and compile before recording, so a rejected
+                    // definition never enters the environment.
+                    let candidate = self.definitions_source(Some((&name, code)));
+                    if let Some(jit) = self.jit() {
+                        jit.define(&candidate)?;
+                    }
+
+                    self.insert_definition(Definition {
                         name,
                         kind: kind.to_string(),
                         source: code.to_string(),
@@ -385,31 +485,67 @@ impl ReplSession {
         let source = self.wrap_for_evaluation(code);
 
         let mut parser = Parser::new(&source);
-        match parser.parse_program() {
-            Ok(_ast) => {
-                // Check if this is a let binding
-                let trimmed = code.trim();
-                if trimmed.starts_with("let ") {
-                    // Extract variable name and store binding
-                    if let Some(eq_pos) = trimmed.find('=') {
-                        let name_part = &trimmed[4..eq_pos].trim();
-                        // Handle pattern: let name: Type = value or let name = value
-                        let name = name_part.split(':').next().unwrap_or(name_part).trim();
-                        self.bindings.insert(name.to_string(), Binding {
-                            name: name.to_string(),
-                            type_str: "inferred".to_string(),
-                            source: code.to_string(),
-                        });
-                        return Ok(format!("{} = ...", name.cyan()));
-                    }
-                }
+        if let Err(e) = parser.parse_program() {
+            return Err(ReplError::ParseError(format!("{:?}", e)));
+        }
 
-                // Design decision: REPL operates in parse-only mode (see module doc)
-                Ok(format!("{}", "(parse mode: expression is valid. Use 'blood run <file>' to execute.)".dimmed()))
+        // Check if this is a let binding
+        let trimmed = code.trim();
+        let let_name = if trimmed.starts_with("let ") {
+            trimmed.find('=').map(|eq_pos| {
+                // Handle pattern: let name: Type = value or let name = value
+                let name_part = trimmed[4..eq_pos].trim();
+                let name_part = name_part.strip_prefix("mut ").unwrap_or(name_part);
+                name_part.split(':').next().unwrap_or(name_part).trim().to_string()
+            })
+        } else {
+            None
+        };
+
+        let definitions = self.definitions_source(None);
+        let show_types = self.show_types;
+        let Some(jit) = self.jit() else {
+            // Parse-only mode (see module doc)
+            if let Some(name) = let_name {
+                self.insert_binding(Binding {
+                    name: name.clone(),
+                    type_str: "inferred".to_string(),
+                    source: code.to_string(),
+                });
+                return Ok(format!("{} = ...", name.cyan()));
             }
-            Err(e) => {
-                Err(ReplError::ParseError(format!("{:?}", e)))
+            return Ok(format!("{}", "(parse mode: expression is valid. Use 'blood run <file>' to execute.)".dimmed()));
+        };
+
+        let input = match &let_name {
+            Some(name) => EvalInput::Let { name: name.as_str(), stmt: code },
+            None => EvalInput::Expr(code),
+        };
+        let outcome = jit.eval(&definitions, input)?;
+
+        let rendered = outcome
+            .value
+            .clone()
+            .unwrap_or_else(|| format!("<{}>", outcome.ty));
+        let typed = if show_types {
+            format!("{} {}", rendered, format!(": {}", outcome.ty).dimmed())
+        } else {
+            rendered
+        };
+
+        match let_name {
+            Some(name) => {
+                // The value itself lives in the JIT; the source is only
+                // used to parse-check later inputs.
+                self.insert_binding(Binding {
+                    name: name.clone(),
+                    type_str: outcome.ty.clone(),
+                    source: code.to_string(),
+                });
+                Ok(format!("{} = {}", name.cyan(), typed))
             }
+            None if outcome.ty == "()" => Ok(String::new()),
+            None => Ok(typed),
         }
     }
 
@@ -418,17 +554,14 @@ impl ReplSession {
         let mut source = String::new();
 
         // Add existing definitions
-        for (_, def) in &self.definitions {
-            source.push_str(&def.source);
-            source.push('\n');
-        }
+        source.push_str(&self.definitions_source(None));
 
         // Wrap expression in a function
         source.push_str("fn __repl_type_check__() {\n");
 
         // Add bindings as let statements
-        for (_, binding) in &self.bindings {
-            source.push_str(&format!("    {};\n", binding.source));
+        for binding in self.binding_sources() {
+            source.push_str(&format!("    {};\n", binding));
         }
 
         source.push_str(&format!("    {}\n", expr));
@@ -442,17 +575,14 @@ impl ReplSession {
         let mut source = String::new();
 
         // Add existing definitions
-        for (_, def) in &self.definitions {
-            source.push_str(&def.source);
-            source.push('\n');
-        }
+        source.push_str(&self.definitions_source(None));
 
         // Wrap in a main function
         source.push_str("fn __repl_eval__() {\n");
 
         // Add existing bindings
-        for (_, binding) in &self.bindings {
-            source.push_str(&format!("    {};\n", binding.source));
+        for binding in self.binding_sources() {
+            source.push_str(&format!("    {};\n", binding));
         }
 
         // Add the code with appropriate termination
@@ -56,6 +56,11 @@ fn run_repl() -> RlResult<ExitCode> {
     let _ = rl.load_history(&history_path);
 
     let mut session = ReplSession::new();
+    if !session.is_evaluating() {
+        let reason = session.jit_unavailable_reason().unwrap_or_default();
+        println!("{}", format!("Parse-only mode: {}", reason).yellow());
+        println!();
+    }
     let mut multiline_buffer = String::new();
     let mut in_multiline = false;
 
@@ -0,0 +1,209 @@
+//! Scripted REPL session against the JIT backend.
+//!
+//! Each test drives a `ReplSession` through a fixed script of inputs and
+//! checks the printed results. The Blood runtime shared library is a
+//! prerequisite: unless `BLOOD_REPL_RUNTIME` points at one, the first test
+//! builds `blood-runtime` in the bootstrap workspace, and a runtime that
+//! still cannot be found fails the tests. The stdlib defaults to the one in
+//! this repository (override with `BLOOD_STDLIB_PATH`).
+
+use std::env::consts::{DLL_PREFIX, DLL_SUFFIX};
+use std::path::{Path, PathBuf};
+use std::process::Command;
+use std::sync::OnceLock;
+use std::time::{Duration, Instant};
+
+use blood_repl::ReplSession;
+
+/// Round-trip budget for a simple expression once the session is warm.
+const ROUND_TRIP_BUDGET: Duration = Duration::from_millis(50);
+
+/// Run `script` and return each input's output with colors stripped.
+fn run_script(session: &mut ReplSession, script: &[&str]) -> Vec<String> {
+    colored::control::set_override(false);
+    script
+        .iter()
+        .map(|input| match session.execute(input) {
+            Ok(out) => out,
+            Err(e) => panic!("input {:?} failed: {}", input, e),
+        })
+        .collect()
+}
+
+/// Path of the runtime shared library, built on first use.
+fn runtime_dylib() -> &'static Path {
+    static RUNTIME: OnceLock<PathBuf> = OnceLock::new();
+    RUNTIME.get_or_init(|| {
+        if let Some(path) = std::env::var_os("BLOOD_REPL_RUNTIME") {
+            return PathBuf::from(path);
+        }
+        let bootstrap = Path::new(env!("CARGO_MANIFEST_DIR")).join("../..");
+        let mut cargo = Command::new(env!("CARGO"));
+        cargo
+            .args(["build", "-p", "blood-runtime", "--manifest-path"])
+            .arg(bootstrap.join("Cargo.toml"));
+        let profile = if cfg!(debug_assertions) {
+            "debug"
+        } else {
+            cargo.arg("--release");
+            "release"
+        };
+        let status = cargo.status().expect("failed to run cargo");
+        assert!(status.success(), "building blood-runtime failed: {}", status);
+        std::env::var_os("CARGO_TARGET_DIR")
+            .map(PathBuf::from)
+            .unwrap_or_else(|| bootstrap.join("target"))
+            .join(profile)
+            .join(format!("{}blood_runtime{}", DLL_PREFIX, DLL_SUFFIX))
+    })
+}
+
+/// A session that evaluates input; panics if the JIT cannot start.
+fn jit_session() -> ReplSession {
+    let runtime = runtime_dylib();
+    assert!(
+        runtime.exists(),
+        "Blood runtime shared library not found at {}",
+        runtime.display()
+    );
+    std::env::set_var("BLOOD_REPL_RUNTIME", runtime);
+    if std::env::var_os("BLOOD_STDLIB_PATH").is_none() {
+        let stdlib = Path::new(env!("CARGO_MANIFEST_DIR")).join("../../../../stdlib");
+        std::env::set_var("BLOOD_STDLIB_PATH", stdlib);
+    }
+    let mut session = ReplSession::new();
+    assert!(
+        session.is_evaluating(),
+        "JIT unavailable: {}",
+        session.jit_unavailable_reason().unwrap_or_default()
+    );
+    session
+}
+
+#[test]
+fn test_expressions_evaluate() {
+    let mut session = jit_session();
+    let out = run_script(&mut session, &["1 + 2", "10 * 4 + 2", "7 > 3", "1.5 * 2.0"]);
+    assert!(out[0].starts_with("3 "), "got {:?}", out[0]);
+    assert!(out[1].starts_with("42 "), "got {:?}", out[1]);
+    assert!(out[2].starts_with("true "), "got {:?}", out[2]);
+    assert!(out[3].starts_with("3.0 "), "got {:?}", out[3]);
+}
+
+#[test]
+fn test_bindings_persist_across_inputs() {
+    let mut session = jit_session();
+    let out = run_script(&mut session, &["let x: i32 = 20", "let y = x + 1", "x + y"]);
+    assert!(out[0].contains("= 20"), "got {:?}", out[0]);
+    assert!(out[1].contains("= 21"), "got {:?}", out[1]);
+    assert!(out[2].starts_with("41 "), "got {:?}", out[2]);
+}
+
+#[test]
+fn test_mutation_persists_across_inputs() {
+    let mut session = jit_session();
+    let out = run_script(
+        &mut session,
+        &[
+            "struct Counter { n: i64 }",
+            "let mut x: i32 = 1",
+            "x = x + 1",
+            "x",
+            "let mut c = Counter { n: 10 }",
+            "c.n = c.n * 3",
+            "c.n + 1",
+        ],
+    );
+    assert!(out[3].starts_with("2 "), "got {:?}", out[3]);
+    assert!(out[6].starts_with("31 "), "got {:?}", out[6]);
+}
+
+#[test]
+fn test_aggregate_bindings_keep_layout() {
+    // Fields of mixed size and alignment, so a slot with the wrong size or
+    // alignment shows up as a wrong value on the next input.
+    let mut session = jit_session();
+    let out = run_script(
+        &mut session,
+        &[
+            "struct Mixed { tag: u8, wide: i64, flag: bool, ratio: f64, small: u16 }",
+            "let mut m = Mixed { tag: 7, wide: 1099511627776, flag: true, ratio: 0.5, small: 300 }",
+            "m.wide = m.wide + m.tag as i64",
+            "m.small = m.small + 1",
+            "m.wide",
+            "m.ratio * 4.0",
+            "m.small",
+            "m.flag",
+            "let mut t: (u8, i64, u16) = (1, 2, 3)",
+            "t.1 = t.1 * 10",
+            "t.0 as i64 + t.1 + t.2 as i64",
+            "let a: [u16; 3] = [10, 20, 30]",
+            "a[0] + a[2]",
+        ],
+    );
+    assert!(out[4].starts_with("1099511627783 "), "got {:?}", out[4]);
+    assert!(out[5].starts_with("2.0 "), "got {:?}", out[5]);
+    assert!(out[6].starts_with("301 "), "got {:?}", out[6]);
+    assert!(out[7].starts_with("true "), "got {:?}", out[7]);
+    assert!(out[10].starts_with("24 "), "got {:?}", out[10]);
+    assert!(out[12].starts_with("40 "), "got {:?}", out[12]);
+}
+
+#[test]
+fn test_stdlib_prelude_in_scope() {
+    let mut session = jit_session();
+    let out = run_script(&mut session, &["max(3, 9)", "let c = clamp(15, 0, 10)", "min(c, 4)"]);
+    assert!(out[0].starts_with("9 "), "got {:?}", out[0]);
+    assert!(out[1].contains("= 10"), "got {:?}", out[1]);
+    assert!(out[2].starts_with("4 "), "got {:?}", out[2]);
+}
+
+#[test]
+fn test_redefinition_recompiles_dependents() {
+    let mut session = jit_session();
+    let out = run_script(
+        &mut session,
+        &[
+            "fn base() -> i32 { 1 }",
+            "fn twice() -> i32 { base() * 2 }",
+            "twice()",
+            "fn base() -> i32 { 5 }",
+            "twice()",
+        ],
+    );
+    assert!(out[2].starts_with("2 "), "got {:?}", out[2]);
+    assert!(out[4].starts_with("10 "), "got {:?}", out[4]);
+}
+
+#[test]
+fn test_type_errors_do_not_enter_environment() {
+    let mut session = jit_session();
+    assert!(session.execute("fn bad() -> i32 { true }").is_err());
+    // `bad` was rejected, so later inputs still compile.
+    let out = run_script(&mut session, &["2 + 2"]);
+    assert!(out[0].starts_with("4 "), "got {:?}", out[0]);
+}
+
+#[test]
+#[cfg_attr(debug_assertions, ignore = "latency budget applies to release builds")]
+fn test_simple_expression_round_trip() {
+    let mut session = jit_session();
+    run_script(&mut session, &["fn sq(n: i64) -> i64 { n * n }", "sq(3)"]);
+
+    let mut samples: Vec<Duration> = (0..9)
+        .map(|i| {
+            let input = format!("sq({}) + 1", i);
+            let start = Instant::now();
+            session.execute(&input).expect("evaluation failed");
+            start.elapsed()
+        })
+        .collect();
+    samples.sort();
+    let median = samples[samples.len() / 2];
+    assert!(
+        median < ROUND_TRIP_BUDGET,
+        "median round trip {:?} exceeds {:?}",
+        median,
+        ROUND_TRIP_BUDGET
+    );
+}
@@ -349,11 +349,82 @@ fn bench_cache_operations(c: &mut Criterion) {
     group.finish();
 }
 
+/// Synthetic project module: 20 public functions with effect rows.
+fn project_module_source(module: usize, seed: usize) -> String {
+    let mut source = String::new();
+    for f in 0..20 {
+        source.push_str(&format!(
+            "pub fn m{}_f{}(x: i32) -> i32 / {{IO}} {{\n    let y = x + {};\n    y * 2\n}}\n\n",
+            module,
+            f,
+            seed + f
+        ));
+    }
+    source
+}
+
+fn bench_project_rebuild(c: &mut Criterion) {
+    use bloodc::hir::DefId;
+    use bloodc::project::{ModuleId, ProjectCompiler};
+    use std::collections::HashSet;
+
+    const MODULES: usize = 200;
+
+    let mut group = c.benchmark_group("project_rebuild");
+
+    // 200 modules, each importing the two before it
+    let dir = tempfile::TempDir::new().unwrap();
+    let root = dir.path().to_path_buf();
+    let files: Vec<_> = (0..MODULES)
+        .map(|i| root.join(format!("m{}.blood", i)))
+        .collect();
+    for (i, file) in files.iter().enumerate() {
+        std::fs::write(file, project_module_source(i, 0)).unwrap();
+    }
+    {
+        let mut compiler = ProjectCompiler::new(root.clone());
+        compiler.init().unwrap();
+        for (i, file) in files.iter().enumerate() {
+            let id = i as u32;
+            compiler.update_file(file).unwrap();
+            compiler.register_module(file, ModuleId::new(id));
+            let defs: HashSet<_> = (0..20).map(|d| DefId::new(id * 20 + d)).collect();
+            compiler.register_definitions(file, defs);
+            if id >= 1 {
+                compiler.add_dependency(ModuleId::new(id), ModuleId::new(id - 1));
+            }
+            if id >= 2 {
+                compiler.add_dependency(ModuleId::new(id), ModuleId::new(id - 2));
+            }
+        }
+        compiler.save().unwrap();
+    }
+
+    let load_and_analyze = || {
+        let mut compiler = ProjectCompiler::new(root.clone());
+        compiler.init().unwrap();
+        compiler.analyze(&files)
+    };
+
+    group.bench_function("no_op", |b| b.iter(|| black_box(load_and_analyze())));
+
+    // Body-only edit at the root of the dependency chain: one module re-checked
+    std::thread::sleep(std::time::Duration::from_millis(1100));
+    std::fs::write(&files[0], project_module_source(0, 7)).unwrap();
+    assert_eq!(load_and_analyze().changed_files.len(), 1);
+    group.bench_function("single_body_edit", |b| {
+        b.iter(|| black_box(load_and_analyze()))
+    });
+
+    group.finish();
+}
+
 criterion_group!(
     benches,
     bench_blake3_hash,
     bench_hir_hash,
     bench_hash_comparison,
     bench_cache_operations,
+    bench_project_rebuild,
 );
 criterion_main!(benches);
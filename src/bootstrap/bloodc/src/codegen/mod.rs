@@ -497,6 +497,60 @@ pub fn compile_definition_to_object(
     opt_level: BloodOptLevel,
 ) -> Result<(), Vec<Diagnostic>> {
     let context = Context::create();
+    let module = compile_definition_to_module(
+        &context,
+        def_id,
+        hir_crate,
+        mir_body,
+        escape_results,
+        all_mir_bodies,
+        inline_handler_bodies,
+        builtin_def_ids,
+        closure_analysis,
+        opt_level,
+        Some(output_path),
+    )?;
+
+    // Write object file
+    let target_machine = get_native_target_machine_with_opt(opt_level)
+        .map_err(|e| vec![Diagnostic::error(e, crate::span::Span::dummy())])?;
+    target_machine
+        .write_to_file(&module, FileType::Object, output_path)
+        .map_err(|e| {
+            vec![Diagnostic::error(
+                format!("Failed to write object file: {}", e.to_string()),
+                crate::span::Span::dummy(),
+            )]
+        })?;
+
+    Ok(())
+}
+
+/// Compile a single definition into its own verified, optimized LLVM module.
+///
+/// This is the in-memory half of [`compile_definition_to_object`]: the module
+/// is created in the caller's `context`, so it can be handed to an execution
+/// engine (the REPL JIT) instead of being written to disk. Other definitions
+/// are declared as external symbols exactly as in the object-file path, so a
+/// JIT that already holds those definitions resolves them by name.
+///
+/// `ir_dump_base`, when set, is the path the `BLOOD_DUMP_UNOPT_IR` /
+/// `BLOOD_DUMP_OPT_IR` dumps are derived from.
+// Compiler-internal: decomposing would reduce clarity
+#[allow(clippy::too_many_arguments)]
+pub fn compile_definition_to_module<'ctx>(
+    context: &'ctx Context,
+    def_id: DefId,
+    hir_crate: &hir::Crate,
+    mir_body: Option<&MirBody>,
+    escape_results: Option<&crate::mir::EscapeResults>,
+    all_mir_bodies: Option<&MirBodiesMap>,
+    inline_handler_bodies: Option<&InlineHandlerBodies>,
+    builtin_def_ids: (Option<DefId>, Option<DefId>, Option<DefId>, Option<DefId>),
+    closure_analysis: Option<&ClosureAnalysisResults>,
+    opt_level: BloodOptLevel,
+    ir_dump_base: Option<&Path>,
+) -> Result<Module<'ctx>, Vec<Diagnostic>> {
     let module_name = format!("blood_def_{}", def_id.index());
     let module = context.create_module(&module_name);
     let builder = context.create_builder();
@@ -506,7 +560,7 @@ pub fn compile_definition_to_object(
         .map_err(|e| vec![Diagnostic::error(e, crate::span::Span::dummy())])?;
     configure_module_target(&module, &target_machine);
 
-    let mut codegen = CodegenContext::new(&context, &module, &builder);
+    let mut codegen = CodegenContext::new(context, &module, &builder);
     codegen.set_builtin_def_ids(
         builtin_def_ids.0,
         builtin_def_ids.1,
@@ -597,12 +651,14 @@ pub fn compile_definition_to_object(
     }
 
     // Dump IR before optimization if requested
-    if std::env::var("BLOOD_DUMP_UNOPT_IR").is_ok() {
-        let ir_path = output_path.with_extension("unopt.ll");
-        if let Err(e) = module.print_to_file(&ir_path) {
-            eprintln!("Warning: Failed to write unoptimized IR: {}", e);
-        } else {
-            eprintln!("Wrote unoptimized IR to: {:?}", ir_path);
+    if let Some(output_path) = ir_dump_base {
+        if std::env::var("BLOOD_DUMP_UNOPT_IR").is_ok() {
+            let ir_path = output_path.with_extension("unopt.ll");
+            if let Err(e) = module.print_to_file(&ir_path) {
+                eprintln!("Warning: Failed to write unoptimized IR: {}", e);
+            } else {
+                eprintln!("Wrote unoptimized IR to: {:?}", ir_path);
+            }
         }
     }
 
@@ -615,26 +671,18 @@ pub fn compile_definition_to_object(
     }
 
     // Dump IR after optimization if requested
-    if std::env::var("BLOOD_DUMP_OPT_IR").is_ok() {
-        let ir_path = output_path.with_extension("opt.ll");
-        if let Err(e) = module.print_to_file(&ir_path) {
-            eprintln!("Warning: Failed to write optimized IR: {}", e);
-        } else {
-            eprintln!("Wrote optimized IR to: {:?}", ir_path);
+    if let Some(output_path) = ir_dump_base {
+        if std::env::var("BLOOD_DUMP_OPT_IR").is_ok() {
+            let ir_path = output_path.with_extension("opt.ll");
+            if let Err(e) = module.print_to_file(&ir_path) {
+                eprintln!("Warning: Failed to write optimized IR: {}", e);
+            } else {
+                eprintln!("Wrote optimized IR to: {:?}", ir_path);
+            }
         }
     }
 
-    // Write object file (target_machine created earlier for data layout)
-    target_machine
-        .write_to_file(&module, FileType::Object, output_path)
-        .map_err(|e| {
-            vec![Diagnostic::error(
-                format!("Failed to write object file: {}", e.to_string()),
-                crate::span::Span::dummy(),
-            )]
-        })?;
-
-    Ok(())
+    Ok(module)
 }
 
 /// Compile handler registration code to a separate object file.
@@ -653,6 +701,36 @@ pub fn compile_handler_registration_to_object(
     builtin_def_ids: (Option<DefId>, Option<DefId>, Option<DefId>, Option<DefId>),
 ) -> Result<(), Vec<Diagnostic>> {
     let context = Context::create();
+    let module = compile_handler_registration_to_module(&context, hir_crate, builtin_def_ids)?;
+
+    // Write object file
+    let target_machine = get_native_target_machine_with_opt(BloodOptLevel::Default)
+        .map_err(|e| vec![Diagnostic::error(e, crate::span::Span::dummy())])?;
+    target_machine
+        .write_to_file(&module, FileType::Object, output_path)
+        .map_err(|e| {
+            vec![Diagnostic::error(
+                format!(
+                    "Failed to write handler registration object: {}",
+                    e.to_string()
+                ),
+                crate::span::Span::dummy(),
+            )]
+        })?;
+
+    Ok(())
+}
+
+/// Build the handler registration module in the caller's `context`.
+///
+/// The module's global constructor must run (object link, or
+/// `ExecutionEngine::run_static_constructors` under the JIT) before any
+/// handler is installed.
+pub fn compile_handler_registration_to_module<'ctx>(
+    context: &'ctx Context,
+    hir_crate: &hir::Crate,
+    builtin_def_ids: (Option<DefId>, Option<DefId>, Option<DefId>, Option<DefId>),
+) -> Result<Module<'ctx>, Vec<Diagnostic>> {
     let module = context.create_module("blood_handler_registration");
     let builder = context.create_builder();
 
@@ -661,7 +739,7 @@ pub fn compile_handler_registration_to_object(
         .map_err(|e| vec![Diagnostic::error(e, crate::span::Span::dummy())])?;
     configure_module_target(&module, &target_machine);
 
-    let mut codegen = CodegenContext::new(&context, &module, &builder);
+    let mut codegen = CodegenContext::new(context, &module, &builder);
     codegen.set_builtin_def_ids(
         builtin_def_ids.0,
         builtin_def_ids.1,
@@ -692,20 +770,47 @@ pub fn compile_handler_registration_to_object(
     // Run LLVM optimization passes
     optimize_module(&module, BloodOptLevel::Aggressive, &target_machine);
 
-    // Write object file
-    target_machine
-        .write_to_file(&module, FileType::Object, output_path)
-        .map_err(|e| {
-            vec![Diagnostic::error(
-                format!(
-                    "Failed to write handler registration object: {}",
-                    e.to_string()
-                ),
-                crate::span::Span::dummy(),
-            )]
-        })?;
+    Ok(module)
+}
 
-    Ok(())
+/// Build a module holding one zero-initialized, mutable global named
+/// `symbol` with the lowered layout of `ty`.
+///
+/// The REPL keeps `let` bindings in these so their values live in the
+/// execution engine across inputs, and reads and writes them through a
+/// `*T` of the binding type, so the global is given the type's ABI
+/// alignment explicitly. `hir_crate` supplies the ADT declarations `ty`
+/// may refer to.
+pub fn compile_storage_slot_to_module<'ctx>(
+    context: &'ctx Context,
+    hir_crate: &hir::Crate,
+    builtin_def_ids: (Option<DefId>, Option<DefId>, Option<DefId>, Option<DefId>),
+    ty: &hir::Type,
+    symbol: &str,
+) -> Result<Module<'ctx>, Vec<Diagnostic>> {
+    let module = context.create_module(&format!("blood_slot_{}", symbol));
+    let builder = context.create_builder();
+
+    let target_machine = get_native_target_machine_with_opt(BloodOptLevel::None)
+        .map_err(|e| vec![Diagnostic::error(e, crate::span::Span::dummy())])?;
+    configure_module_target(&module, &target_machine);
+
+    let mut codegen = CodegenContext::new(context, &module, &builder);
+    codegen.set_builtin_def_ids(
+        builtin_def_ids.0,
+        builtin_def_ids.1,
+        builtin_def_ids.2,
+        builtin_def_ids.3,
+    );
+    codegen.compile_crate_declarations(hir_crate)?;
+
+    let llvm_type = codegen.lower_type(ty);
+    let global = module.add_global(llvm_type, Some(inkwell::AddressSpace::default()), symbol);
+    global.set_initializer(&llvm_type.const_zero());
+    global.set_constant(false);
+    global.set_alignment(target_machine.get_target_data().get_abi_alignment(&llvm_type));
+
+    Ok(module)
 }
 
 /// Compile multiple definitions to separate object files.
@@ -558,6 +558,10 @@ pub fn verify_effects_subset(
     inferred: &EffectRow,
     declared: &EffectRow,
 ) -> Result<(), Vec<EffectRef>> {
+    if declared.is_polymorphic() || inferred.is_subset_of(declared) {
+        return Ok(());
+    }
+
     let mut undeclared = Vec::new();
 
     for effect in inferred.effects() {
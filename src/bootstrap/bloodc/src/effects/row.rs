@@ -21,7 +21,7 @@
 //! 3. Handle row variables for remaining effects
 
 use crate::hir::DefId;
-use std::collections::BTreeSet;
+use std::cmp::Ordering;
 
 /// A row variable for effect polymorphism.
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
@@ -62,29 +62,41 @@ impl EffectRef {
 ///
 /// Effect rows support row polymorphism through an optional row variable,
 /// enabling functions to be polymorphic over unknown additional effects.
+///
+/// The concrete effects are kept in canonical form: sorted by definition
+/// index with no duplicates. Alongside them, `mask` sets bit
+/// `def_id.index % 64` for every effect, so most failed membership and
+/// subset checks are decided without touching the effects at all.
 #[derive(Debug, Clone, PartialEq, Eq)]
 pub struct EffectRow {
-    /// The concrete effects in this row.
-    effects: BTreeSet<EffectRef>,
+    /// The concrete effects in this row, sorted by `def_id.index`.
+    effects: Vec<EffectRef>,
+    /// Summary bitset of `effects`, one bit per `def_id.index % 64`.
+    mask: u64,
     /// Optional row variable for polymorphism.
     row_var: Option<RowVar>,
 }
 
+/// Bit of `EffectRow::mask` covering `effect`.
+fn mask_bit(effect: &EffectRef) -> u64 {
+    1u64 << (effect.def_id.index % 64)
+}
+
 impl EffectRow {
     /// Create an empty effect row (pure).
     pub fn pure() -> Self {
         Self {
-            effects: BTreeSet::new(),
+            effects: Vec::new(),
+            mask: 0,
             row_var: None,
         }
     }
 
     /// Create an effect row with a single effect.
     pub fn single(effect: EffectRef) -> Self {
-        let mut effects = BTreeSet::new();
-        effects.insert(effect);
         Self {
-            effects,
+            mask: mask_bit(&effect),
+            effects: vec![effect],
             row_var: None,
         }
     }
@@ -92,14 +104,18 @@ impl EffectRow {
     /// Create a polymorphic effect row with just a row variable.
     pub fn polymorphic(row_var: RowVar) -> Self {
         Self {
-            effects: BTreeSet::new(),
+            effects: Vec::new(),
+            mask: 0,
             row_var: Some(row_var),
         }
     }
 
-    /// Add an effect to this row.
+    /// Add an effect to this row. An effect already present is kept as is.
     pub fn add_effect(&mut self, effect: EffectRef) {
-        self.effects.insert(effect);
+        if let Err(pos) = self.position(&effect) {
+            self.mask |= mask_bit(&effect);
+            self.effects.insert(pos, effect);
+        }
     }
 
     /// Set the row variable for polymorphism.
@@ -117,7 +133,7 @@ impl EffectRow {
         self.row_var.is_some()
     }
 
-    /// Get the concrete effects in this row.
+    /// Get the concrete effects in this row, in definition order.
     pub fn effects(&self) -> impl Iterator<Item = &EffectRef> {
         self.effects.iter()
     }
@@ -129,16 +145,65 @@ impl EffectRow {
 
     /// Check if this row contains a specific effect.
     pub fn contains(&self, effect: &EffectRef) -> bool {
-        self.effects.contains(effect)
+        self.mask & mask_bit(effect) != 0 && self.position(effect).is_ok()
+    }
+
+    /// Check if every concrete effect of this row is in `other`.
+    ///
+    /// Row variables are not considered.
+    pub fn is_subset_of(&self, other: &EffectRow) -> bool {
+        if self.mask & !other.mask != 0 || self.effects.len() > other.effects.len() {
+            return false;
+        }
+        // Merge walk: both sides are sorted, so each side is read once.
+        let mut j = 0;
+        for effect in &self.effects {
+            let index = effect.def_id.index;
+            while j < other.effects.len() && other.effects[j].def_id.index < index {
+                j += 1;
+            }
+            if j == other.effects.len() || other.effects[j].def_id.index != index {
+                return false;
+            }
+            j += 1;
+        }
+        true
     }
 
     /// Extend this row with effects from another row.
     pub fn extend(&mut self, other: &EffectRow) {
-        self.effects.extend(other.effects.iter().cloned());
+        if !other.is_subset_of(self) {
+            let mut merged = Vec::with_capacity(self.effects.len() + other.effects.len());
+            let mut mine = std::mem::take(&mut self.effects).into_iter().peekable();
+            let mut theirs = other.effects.iter().peekable();
+            loop {
+                match (mine.peek(), theirs.peek()) {
+                    (Some(a), Some(b)) => match a.def_id.index.cmp(&b.def_id.index) {
+                        Ordering::Less => merged.extend(mine.next()),
+                        Ordering::Greater => merged.extend(theirs.next().cloned()),
+                        Ordering::Equal => {
+                            merged.extend(mine.next());
+                            theirs.next();
+                        }
+                    },
+                    (Some(_), None) => merged.extend(mine.by_ref()),
+                    (None, Some(_)) => merged.extend(theirs.by_ref().cloned()),
+                    (None, None) => break,
+                }
+            }
+            self.effects = merged;
+            self.mask |= other.mask;
+        }
         if other.row_var.is_some() && self.row_var.is_none() {
             self.row_var = other.row_var;
         }
     }
+
+    /// Where `effect` is, or would be inserted, in `effects`.
+    fn position(&self, effect: &EffectRef) -> Result<usize, usize> {
+        self.effects
+            .binary_search_by_key(&effect.def_id.index, |e| e.def_id.index)
+    }
 }
 
 impl Default for EffectRow {
@@ -147,15 +212,15 @@ impl Default for EffectRow {
     }
 }
 
-// Implement Ord for EffectRef to allow use in BTreeSet
+// Effects are ordered by definition only; this is the canonical row order
 impl PartialOrd for EffectRef {
-    fn partial_cmp(&self, other: &Self) -> Option<std::cmp::Ordering> {
+    fn partial_cmp(&self, other: &Self) -> Option<Ordering> {
         Some(self.cmp(other))
     }
 }
 
 impl Ord for EffectRef {
-    fn cmp(&self, other: &Self) -> std::cmp::Ordering {
+    fn cmp(&self, other: &Self) -> Ordering {
         self.def_id.index.cmp(&other.def_id.index)
     }
 }
@@ -199,4 +264,40 @@ mod tests {
         assert!(row1.contains(&effect1));
         assert!(row1.contains(&effect2));
     }
+
+    #[test]
+    fn test_row_is_canonical() {
+        let mut row = EffectRow::pure();
+        for index in [5, 1, 70, 5, 3] {
+            row.add_effect(EffectRef::new(DefId::new(index)));
+        }
+        let indices: Vec<u32> = row.effects().map(|e| e.def_id.index).collect();
+        assert_eq!(indices, vec![1, 3, 5, 70]);
+
+        // Insertion order does not matter for equality
+        let mut other = EffectRow::pure();
+        for index in [70, 3, 1, 5] {
+            other.add_effect(EffectRef::new(DefId::new(index)));
+        }
+        assert_eq!(row, other);
+    }
+
+    #[test]
+    fn test_subset_with_mask_collisions() {
+        // 6 and 70 share a mask bit, so the mask alone cannot decide these
+        let mut small = EffectRow::single(EffectRef::new(DefId::new(6)));
+        let mut large = EffectRow::single(EffectRef::new(DefId::new(70)));
+        assert!(!small.is_subset_of(&large));
+        assert!(!large.contains(&EffectRef::new(DefId::new(6))));
+
+        large.add_effect(EffectRef::new(DefId::new(6)));
+        large.add_effect(EffectRef::new(DefId::new(2)));
+        assert!(small.is_subset_of(&large));
+        assert!(!large.is_subset_of(&small));
+
+        small.extend(&large);
+        assert!(large.is_subset_of(&small));
+        assert_eq!(small, large);
+        assert!(EffectRow::pure().is_subset_of(&small));
+    }
 }
@@ -12,7 +12,8 @@
 //! ```text
 //! 1. Load file cache and build cache from disk
 //! 2. Scan source files for changes
-//! 3. Identify changed files and their dependencies
+//! 3. Identify changed files, and the dependents of those whose
+//!    interface fingerprint changed
 //! 4. Invalidate cached artifacts for changed definitions
 //! 5. Parse/type-check only changed files
 //! 6. Compile changed definitions
@@ -35,6 +36,9 @@ use crate::hir::DefId;
 pub struct IncrementalAnalysis {
     /// Files that need to be recompiled.
     pub changed_files: Vec<PathBuf>,
+    /// Changed files whose interface is unchanged; their dependents are
+    /// not invalidated (a subset of `changed_files`).
+    pub body_only_files: Vec<PathBuf>,
     /// Files that have been deleted.
     pub deleted_files: Vec<PathBuf>,
     /// Files that are unchanged.
@@ -176,6 +180,7 @@ impl ProjectCompiler {
             // No cache or disabled - full rebuild
             return IncrementalAnalysis {
                 changed_files: source_files.to_vec(),
+                body_only_files: Vec::new(),
                 deleted_files: Vec::new(),
                 unchanged_files: Vec::new(),
                 invalidated_defs: HashSet::new(),
@@ -186,6 +191,7 @@ impl ProjectCompiler {
         }
 
         let mut changed_files = Vec::new();
+        let mut body_only_files = Vec::new();
         let mut deleted_files = Vec::new();
         let mut unchanged_files = Vec::new();
 
@@ -193,14 +199,16 @@ impl ProjectCompiler {
         for path in source_files {
             match self.file_cache.check_file(path) {
                 FileStatus::Unchanged => unchanged_files.push(path.clone()),
+                FileStatus::BodyModified => body_only_files.push(path.clone()),
                 FileStatus::Modified | FileStatus::New => changed_files.push(path.clone()),
                 FileStatus::Deleted => deleted_files.push(path.clone()),
             }
         }
 
         // Check for files in cache that are no longer in source list
+        let source_set: HashSet<&PathBuf> = source_files.iter().collect();
         for cached_path in self.file_cache.cached_files() {
-            if !source_files.contains(cached_path) && !deleted_files.contains(cached_path) {
+            if !source_set.contains(cached_path) && !deleted_files.contains(cached_path) {
                 deleted_files.push(cached_path.clone());
             }
         }
@@ -208,20 +216,29 @@ impl ProjectCompiler {
         // Get invalidated definitions from changed/deleted files
         let mut invalidated_defs = self.file_cache.get_invalidated_definitions(&changed_files);
         invalidated_defs.extend(self.file_cache.get_invalidated_definitions(&deleted_files));
+        invalidated_defs.extend(
+            self.file_cache
+                .get_invalidated_definitions(&body_only_files),
+        );
 
-        // Get invalidated modules
+        // Get modules whose interface changed
         let mut invalidated_modules = self.file_cache.get_invalidated_modules(&changed_files);
         invalidated_modules.extend(self.file_cache.get_invalidated_modules(&deleted_files));
 
-        // Use dependency graph to find transitive invalidations
-        let all_invalidated_modules: HashSet<_> = self
+        // Use dependency graph to find transitive invalidations; body-only
+        // edits are re-checked themselves but do not reach their dependents
+        let mut all_invalidated_modules: HashSet<_> = self
             .dep_graph
             .invalidation_set(&invalidated_modules.iter().copied().collect::<Vec<_>>());
+        all_invalidated_modules.extend(self.file_cache.get_invalidated_modules(&body_only_files));
+        changed_files.extend(body_only_files.iter().cloned());
 
         // Add files for transitively invalidated modules
+        let mut changed_set: HashSet<PathBuf> = changed_files.iter().cloned().collect();
         for path in self.file_cache.cached_files() {
             if let Some(module_id) = self.file_cache.get_module(path) {
-                if all_invalidated_modules.contains(&module_id) && !changed_files.contains(path) {
+                if all_invalidated_modules.contains(&module_id) && changed_set.insert(path.clone())
+                {
                     changed_files.push(path.clone());
                     if let Some(defs) = self.file_cache.get_definitions(path) {
                         invalidated_defs.extend(defs.iter().copied());
@@ -232,6 +249,7 @@ impl ProjectCompiler {
 
         IncrementalAnalysis {
             changed_files,
+            body_only_files,
             deleted_files,
             unchanged_files,
             invalidated_defs,
@@ -487,6 +505,50 @@ mod tests {
         }
     }
 
+    #[test]
+    fn test_project_compiler_body_edit_skips_dependents() {
+        let temp_dir = TempDir::new().unwrap();
+
+        let file_a = temp_dir.path().join("a.blood");
+        let file_b = temp_dir.path().join("b.blood");
+        let file_c = temp_dir.path().join("c.blood");
+
+        fs::write(&file_a, "pub fn a() -> i32 { 1 }").unwrap();
+        fs::write(&file_b, "pub fn b() -> i32 { a() }").unwrap();
+        fs::write(&file_c, "pub fn c() -> i32 { b() }").unwrap();
+
+        {
+            let mut compiler = ProjectCompiler::new(temp_dir.path().to_path_buf());
+            compiler.init().unwrap();
+
+            for (i, file) in [&file_a, &file_b, &file_c].into_iter().enumerate() {
+                compiler.update_file(file).unwrap();
+                compiler.register_module(file, ModuleId::new(i as u32));
+                compiler.register_definitions(file, HashSet::from([DefId::new(i as u32)]));
+            }
+            compiler.add_dependency(ModuleId::new(1), ModuleId::new(0));
+            compiler.add_dependency(ModuleId::new(2), ModuleId::new(1));
+
+            compiler.save().unwrap();
+        }
+
+        // Change only the body of a
+        std::thread::sleep(std::time::Duration::from_millis(10));
+        fs::write(&file_a, "pub fn a() -> i32 { 40 + 2 }").unwrap();
+
+        let mut compiler = ProjectCompiler::new(temp_dir.path().to_path_buf());
+        compiler.init().unwrap();
+        let analysis = compiler.analyze(&[file_a.clone(), file_b.clone(), file_c.clone()]);
+
+        assert_eq!(analysis.changed_files, vec![file_a.clone()]);
+        assert_eq!(analysis.body_only_files, vec![file_a]);
+        assert_eq!(
+            analysis.invalidated_modules,
+            HashSet::from([ModuleId::new(0)])
+        );
+        assert_eq!(analysis.invalidated_defs, HashSet::from([DefId::new(0)]));
+    }
+
     #[test]
     fn test_project_compiler_compilation_order() {
         let temp_dir = TempDir::new().unwrap();
@@ -2,15 +2,43 @@
 //!
 //! This module tracks source files and their content hashes to enable
 //! incremental compilation. When a file changes, only that file and its
-//! dependents need to be recompiled.
+//! dependents need to be recompiled, and only the file itself when the
+//! change does not touch its interface.
 //!
 //! ## Cache Structure
 //!
 //! ```text
 //! .blood/
-//! └── file_cache.json    # File hash manifest
+//! └── file_cache.bin     # File hash manifest (binary)
 //! ```
 //!
+//! ## Interface Fingerprints
+//!
+//! Each entry stores two hashes. The content hash covers the raw bytes;
+//! the interface fingerprint covers the file's tokens minus comments and
+//! function bodies, so it captures every signature, effect row, type
+//! declaration and attribute that other modules can observe. An edit
+//! that changes the content hash but not the fingerprint is reported as
+//! `FileStatus::BodyModified`: the file is re-checked, its dependents are
+//! not. Bodies that other modules instantiate (generic functions, `const
+//! fn`, trait default methods) are kept in the fingerprint, and so are
+//! the bodies of functions without an effect annotation, whose effect
+//! row typeck infers from the body.
+//!
+//! ## Binary Format
+//!
+//! ```text
+//! magic "BLFC" | version u32 | entry count u32 | defs length u32
+//! entries:  path (u32 length + UTF-8) | content hash [32]
+//!           | interface flag u8 + hash [32] | mtime u64 | size u64
+//!           | module flag u8 + id u32 | defs offset u32 | defs count u32
+//! defs:     u32 DefId indices
+//! ```
+//!
+//! All integers are little-endian. Entries are decoded on load; the
+//! per-file definition lists stay encoded until `get_definitions` asks
+//! for them, so a no-op rebuild never touches them.
+//!
 //! ## Integration with BuildCache
 //!
 //! The FileCache works alongside the BuildCache:
@@ -19,21 +47,26 @@
 //! 3. When a file changes, all definitions from that file are invalidated
 //! 4. BuildCache handles the actual compiled artifact caching
 
+use std::cell::OnceCell;
 use std::collections::{HashMap, HashSet};
 use std::fs;
 use std::io;
 use std::path::{Path, PathBuf};
 use std::time::SystemTime;
 
-use serde::{Deserialize, Serialize};
-
-use crate::content::hash::ContentHash;
+use crate::ast::{Declaration, FnDecl, ImplItem};
+use crate::content::hash::{ContentHash, ContentHasher};
 use crate::hir::DefId;
+use crate::lexer::{Lexer, TokenKind};
+use crate::parser::Parser;
 
 use super::resolve::ModuleId;
 
 /// Version for the file cache format.
-pub const FILE_CACHE_VERSION: u32 = 1;
+pub const FILE_CACHE_VERSION: u32 = 2;
+
+/// Magic bytes at the start of the file cache.
+pub const FILE_CACHE_MAGIC: [u8; 4] = *b"BLFC";
 
 /// File-level cache for incremental compilation.
 #[derive(Debug)]
@@ -44,6 +77,10 @@ pub struct FileCache {
     entries: HashMap<PathBuf, FileCacheEntry>,
     /// Mapping from file to the definitions it contains.
     file_to_defs: HashMap<PathBuf, HashSet<DefId>>,
+    /// Definition lists loaded from disk, decoded on first use.
+    stored_defs: HashMap<PathBuf, StoredDefs>,
+    /// Encoded definition section of the loaded cache file.
+    defs_data: Vec<u8>,
     /// Mapping from file to its module ID.
     file_to_module: HashMap<PathBuf, ModuleId>,
     /// Whether caching is enabled.
@@ -51,29 +88,27 @@ pub struct FileCache {
 }
 
 /// A cached entry for a single file.
-#[derive(Debug, Clone, Serialize, Deserialize)]
+#[derive(Debug, Clone)]
 pub struct FileCacheEntry {
     /// Content hash of the file.
     pub content_hash: ContentHash,
+    /// Fingerprint of the file's interface (`None` if it did not parse).
+    pub interface_hash: Option<ContentHash>,
     /// Last modification time (for quick change detection).
     pub mtime: u64,
     /// File size in bytes.
     pub size: u64,
-    /// Definition IDs contained in this file.
-    #[serde(default)]
-    pub definitions: Vec<u32>,
-    /// Module ID for this file (if it's a module root).
-    #[serde(default)]
-    pub module_id: Option<u32>,
 }
 
-/// Persistent file cache index.
-#[derive(Debug, Clone, Serialize, Deserialize)]
-struct FileCacheIndex {
-    /// Cache format version.
-    version: u32,
-    /// File entries by relative path.
-    entries: HashMap<String, FileCacheEntry>,
+/// A definition list still encoded in `FileCache::defs_data`.
+#[derive(Debug)]
+struct StoredDefs {
+    /// Byte offset into the definition section.
+    offset: usize,
+    /// Number of definition indices.
+    count: usize,
+    /// The decoded set, filled on first access.
+    decoded: OnceCell<HashSet<DefId>>,
 }
 
 /// Result of checking if a file has changed.
@@ -81,6 +116,8 @@ struct FileCacheIndex {
 pub enum FileStatus {
     /// File has not changed since last cache.
     Unchanged,
+    /// File has been modified, but its interface fingerprint has not.
+    BodyModified,
     /// File has been modified.
     Modified,
     /// File is new (not in cache).
@@ -94,8 +131,8 @@ pub enum FileStatus {
 pub enum FileCacheError {
     /// IO error.
     Io(io::Error),
-    /// JSON serialization/deserialization error.
-    Json(String),
+    /// Malformed cache file.
+    Format(String),
     /// Version mismatch.
     VersionMismatch { expected: u32, found: u32 },
 }
@@ -104,7 +141,7 @@ impl std::fmt::Display for FileCacheError {
     fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
         match self {
             Self::Io(e) => write!(f, "file cache IO error: {}", e),
-            Self::Json(msg) => write!(f, "file cache JSON error: {}", msg),
+            Self::Format(msg) => write!(f, "file cache format error: {}", msg),
             Self::VersionMismatch { expected, found } => {
                 write!(
                     f,
@@ -124,9 +161,113 @@ impl From<io::Error> for FileCacheError {
     }
 }
 
-impl From<serde_json::Error> for FileCacheError {
-    fn from(e: serde_json::Error) -> Self {
-        Self::Json(e.to_string())
+/// Compute the interface fingerprint of a source file.
+///
+/// Hashes the token stream with comments and implementation-only function
+/// bodies removed, so formatting, comment and body edits leave it as is.
+/// Returns `None` if the file does not parse.
+pub fn interface_fingerprint(source: &str) -> Option<ContentHash> {
+    let program = Parser::new(source).parse_program().ok()?;
+
+    let mut hidden = Vec::new();
+    collect_hidden_bodies(&program.declarations, &mut hidden);
+    hidden.sort_unstable();
+
+    let mut hasher = ContentHasher::new();
+    let mut next_hidden = 0;
+    for token in Lexer::new(source) {
+        if matches!(
+            token.kind,
+            TokenKind::DocComment | TokenKind::LineComment | TokenKind::BlockComment
+        ) {
+            continue;
+        }
+        let start = token.span.start;
+        while next_hidden < hidden.len() && hidden[next_hidden].1 <= start {
+            next_hidden += 1;
+        }
+        if next_hidden < hidden.len() && hidden[next_hidden].0 <= start {
+            continue;
+        }
+        hasher.update(&source.as_bytes()[start..token.span.end]);
+        hasher.update_u8(0);
+    }
+    Some(hasher.finalize())
+}
+
+/// Collect the byte ranges of bodies that no other module can observe.
+fn collect_hidden_bodies(decls: &[Declaration], hidden: &mut Vec<(usize, usize)>) {
+    for decl in decls {
+        match decl {
+            Declaration::Function(f) => hide_fn_body(f, hidden),
+            Declaration::Impl(block) if block.type_params.is_none() => {
+                for item in &block.items {
+                    if let ImplItem::Function(f) = item {
+                        hide_fn_body(f, hidden);
+                    }
+                }
+            }
+            Declaration::Handler(handler) if handler.type_params.is_none() => {
+                for op in &handler.operations {
+                    hidden.push((op.body.span.start, op.body.span.end));
+                }
+            }
+            Declaration::Module(module) => {
+                if let Some(body) = &module.body {
+                    collect_hidden_bodies(body, hidden);
+                }
+            }
+            _ => {}
+        }
+    }
+}
+
+fn hide_fn_body(f: &FnDecl, hidden: &mut Vec<(usize, usize)>) {
+    // Generic and const bodies are instantiated or evaluated by callers,
+    // and an unannotated function's effect row is inferred from its body.
+    if f.type_params.is_some() || f.qualifiers.is_const || f.effects.is_none() {
+        return;
+    }
+    if let Some(body) = &f.body {
+        hidden.push((body.span.start, body.span.end));
+    }
+}
+
+/// Bounds-checked little-endian reader over an encoded cache file.
+struct CacheReader<'a> {
+    data: &'a [u8],
+    pos: usize,
+}
+
+impl<'a> CacheReader<'a> {
+    fn bytes(&mut self, len: usize) -> Result<&'a [u8], FileCacheError> {
+        if self.data.len() - self.pos < len {
+            return Err(FileCacheError::Format("unexpected end of data".to_string()));
+        }
+        let bytes = &self.data[self.pos..self.pos + len];
+        self.pos += len;
+        Ok(bytes)
+    }
+
+    fn u8(&mut self) -> Result<u8, FileCacheError> {
+        Ok(self.bytes(1)?[0])
+    }
+
+    fn u32(&mut self) -> Result<u32, FileCacheError> {
+        let bytes = self.bytes(4)?;
+        Ok(u32::from_le_bytes(bytes.try_into().expect("4 bytes read")))
+    }
+
+    fn u64(&mut self) -> Result<u64, FileCacheError> {
+        let bytes = self.bytes(8)?;
+        Ok(u64::from_le_bytes(bytes.try_into().expect("8 bytes read")))
+    }
+
+    fn hash(&mut self) -> Result<ContentHash, FileCacheError> {
+        let bytes = self.bytes(32)?;
+        Ok(ContentHash::from_bytes(
+            bytes.try_into().expect("32 bytes read"),
+        ))
     }
 }
 
@@ -137,6 +278,8 @@ impl FileCache {
             project_root,
             entries: HashMap::new(),
             file_to_defs: HashMap::new(),
+            stored_defs: HashMap::new(),
+            defs_data: Vec::new(),
             file_to_module: HashMap::new(),
             enabled: true,
         }
@@ -145,17 +288,14 @@ impl FileCache {
     /// Create a disabled file cache (no-op for all operations).
     pub fn disabled() -> Self {
         Self {
-            project_root: PathBuf::new(),
-            entries: HashMap::new(),
-            file_to_defs: HashMap::new(),
-            file_to_module: HashMap::new(),
             enabled: false,
+            ..Self::new(PathBuf::new())
         }
     }
 
     /// Get the cache file path.
     fn cache_path(&self) -> PathBuf {
-        self.project_root.join(".blood").join("file_cache.json")
+        self.project_root.join(".blood").join("file_cache.bin")
     }
 
     /// Initialize the cache directory.
@@ -180,43 +320,80 @@ impl FileCache {
             return Ok(false);
         }
 
-        let json = fs::read_to_string(&cache_path)?;
-        let index: FileCacheIndex = serde_json::from_str(&json)?;
+        let data = fs::read(&cache_path)?;
+        let mut reader = CacheReader {
+            data: &data,
+            pos: 0,
+        };
 
-        if index.version != FILE_CACHE_VERSION {
+        if reader.bytes(4)? != FILE_CACHE_MAGIC {
+            return Err(FileCacheError::Format("not a file cache".to_string()));
+        }
+        let version = reader.u32()?;
+        if version != FILE_CACHE_VERSION {
             return Err(FileCacheError::VersionMismatch {
                 expected: FILE_CACHE_VERSION,
-                found: index.version,
+                found: version,
             });
         }
-
-        // Convert relative paths back to absolute
-        self.entries.clear();
-        self.file_to_defs.clear();
-        self.file_to_module.clear();
-
-        for (rel_path, entry) in index.entries {
-            let abs_path = self.project_root.join(&rel_path);
-
-            // Restore file_to_defs mapping
-            let def_ids: HashSet<DefId> = entry
-                .definitions
-                .iter()
-                .map(|&idx| DefId::new(idx))
-                .collect();
-            if !def_ids.is_empty() {
-                self.file_to_defs.insert(abs_path.clone(), def_ids);
+        let count = reader.u32()? as usize;
+        let defs_len = reader.u32()? as usize;
+
+        self.clear();
+
+        for _ in 0..count {
+            let path_len = reader.u32()? as usize;
+            let rel_path = std::str::from_utf8(reader.bytes(path_len)?)
+                .map_err(|_| FileCacheError::Format("path is not UTF-8".to_string()))?;
+            // Relative paths are stored; convert back to absolute
+            let abs_path = self.project_root.join(rel_path);
+
+            let content_hash = reader.hash()?;
+            let interface_hash = match reader.u8()? {
+                0 => None,
+                _ => Some(reader.hash()?),
+            };
+            let mtime = reader.u64()?;
+            let size = reader.u64()?;
+            let module_id = match reader.u8()? {
+                0 => None,
+                _ => Some(reader.u32()?),
+            };
+            let offset = reader.u32()? as usize;
+            let defs_count = reader.u32()? as usize;
+
+            if offset > defs_len || (defs_len - offset) / 4 < defs_count {
+                return Err(FileCacheError::Format(
+                    "definition list out of range".to_string(),
+                ));
             }
-
-            // Restore file_to_module mapping
-            if let Some(module_idx) = entry.module_id {
+            if defs_count > 0 {
+                self.stored_defs.insert(
+                    abs_path.clone(),
+                    StoredDefs {
+                        offset,
+                        count: defs_count,
+                        decoded: OnceCell::new(),
+                    },
+                );
+            }
+            if let Some(module_idx) = module_id {
                 self.file_to_module
                     .insert(abs_path.clone(), ModuleId::new(module_idx));
             }
 
-            self.entries.insert(abs_path, entry);
+            self.entries.insert(
+                abs_path,
+                FileCacheEntry {
+                    content_hash,
+                    interface_hash,
+                    mtime,
+                    size,
+                },
+            );
         }
 
+        self.defs_data = reader.bytes(defs_len)?.to_vec();
         Ok(true)
     }
 
@@ -226,31 +403,71 @@ impl FileCache {
             return Ok(());
         }
 
-        // Convert absolute paths to relative for storage
-        let mut entries = HashMap::new();
-        for (abs_path, entry) in &self.entries {
-            if let Ok(rel_path) = abs_path.strip_prefix(&self.project_root) {
-                let rel_str = rel_path.to_string_lossy().to_string();
-
-                // Include definitions and module_id from our tracking maps
-                let mut entry = entry.clone();
-                if let Some(defs) = self.file_to_defs.get(abs_path) {
-                    entry.definitions = defs.iter().map(|d| d.index).collect();
+        // Sorted so identical caches produce identical files
+        let mut paths: Vec<&PathBuf> = self.entries.keys().collect();
+        paths.sort();
+
+        let mut records = Vec::new();
+        let mut defs = Vec::new();
+        let mut count: u32 = 0;
+        for abs_path in paths {
+            // Convert absolute paths to relative for storage
+            let Ok(rel_path) = abs_path.strip_prefix(&self.project_root) else {
+                continue;
+            };
+            let entry = &self.entries[abs_path];
+            let rel_str = rel_path.to_string_lossy();
+
+            records.extend_from_slice(&(rel_str.len() as u32).to_le_bytes());
+            records.extend_from_slice(rel_str.as_bytes());
+            records.extend_from_slice(entry.content_hash.as_bytes());
+            match &entry.interface_hash {
+                Some(hash) => {
+                    records.push(1);
+                    records.extend_from_slice(hash.as_bytes());
                 }
-                if let Some(module) = self.file_to_module.get(abs_path) {
-                    entry.module_id = Some(module.raw());
+                None => records.push(0),
+            }
+            records.extend_from_slice(&entry.mtime.to_le_bytes());
+            records.extend_from_slice(&entry.size.to_le_bytes());
+            match self.file_to_module.get(abs_path) {
+                Some(module) => {
+                    records.push(1);
+                    records.extend_from_slice(&module.raw().to_le_bytes());
                 }
-
-                entries.insert(rel_str, entry);
+                None => records.push(0),
             }
+
+            // Definitions: freshly registered ones, or the still-encoded list
+            let offset = defs.len();
+            let defs_count = if let Some(registered) = self.file_to_defs.get(abs_path) {
+                let mut indices: Vec<u32> = registered.iter().map(|d| d.index).collect();
+                indices.sort_unstable();
+                for index in &indices {
+                    defs.extend_from_slice(&index.to_le_bytes());
+                }
+                indices.len()
+            } else if let Some(stored) = self.stored_defs.get(abs_path) {
+                defs.extend_from_slice(
+                    &self.defs_data[stored.offset..stored.offset + stored.count * 4],
+                );
+                stored.count
+            } else {
+                0
+            };
+            records.extend_from_slice(&(offset as u32).to_le_bytes());
+            records.extend_from_slice(&(defs_count as u32).to_le_bytes());
+            count += 1;
         }
 
-        let index = FileCacheIndex {
-            version: FILE_CACHE_VERSION,
-            entries,
-        };
+        let mut data = Vec::with_capacity(16 + records.len() + defs.len());
+        data.extend_from_slice(&FILE_CACHE_MAGIC);
+        data.extend_from_slice(&FILE_CACHE_VERSION.to_le_bytes());
+        data.extend_from_slice(&count.to_le_bytes());
+        data.extend_from_slice(&(defs.len() as u32).to_le_bytes());
+        data.extend_from_slice(&records);
+        data.extend_from_slice(&defs);
 
-        let json = serde_json::to_string_pretty(&index)?;
         let cache_path = self.cache_path();
 
         // Ensure parent directory exists
@@ -258,7 +475,7 @@ impl FileCache {
             fs::create_dir_all(parent)?;
         }
 
-        fs::write(cache_path, json)?;
+        fs::write(cache_path, data)?;
         Ok(())
     }
 
@@ -290,7 +507,8 @@ impl FileCache {
     /// Check if a file has changed since the last cache.
     ///
     /// Uses mtime and size for quick checks, falls back to content hash
-    /// if metadata has changed.
+    /// if metadata has changed. A changed file is re-fingerprinted to tell
+    /// body-only edits from interface changes.
     pub fn check_file(&self, path: &Path) -> FileStatus {
         if !self.enabled {
             return FileStatus::New;
@@ -313,15 +531,20 @@ impl FileCache {
         }
 
         // Mtime or size changed - compute content hash to verify
-        match Self::compute_file_hash(path) {
-            Ok(hash) => {
-                if hash == cached.content_hash {
-                    FileStatus::Unchanged
-                } else {
-                    FileStatus::Modified
-                }
-            }
-            Err(_) => FileStatus::Deleted,
+        let content = match fs::read(path) {
+            Ok(content) => content,
+            Err(_) => return FileStatus::Deleted,
+        };
+        if ContentHash::compute(&content) == cached.content_hash {
+            return FileStatus::Unchanged;
+        }
+
+        let interface = std::str::from_utf8(&content)
+            .ok()
+            .and_then(interface_fingerprint);
+        match (interface, cached.interface_hash) {
+            (Some(new), Some(old)) if new == old => FileStatus::BodyModified,
+            _ => FileStatus::Modified,
         }
     }
 
@@ -332,14 +555,17 @@ impl FileCache {
         }
 
         let (mtime, size) = Self::get_file_metadata(path)?;
-        let content_hash = Self::compute_file_hash(path)?;
+        let content = fs::read(path)?;
+        let content_hash = ContentHash::compute(&content);
+        let interface_hash = std::str::from_utf8(&content)
+            .ok()
+            .and_then(interface_fingerprint);
 
         let entry = FileCacheEntry {
             content_hash,
+            interface_hash,
             mtime,
             size,
-            definitions: Vec::new(),
-            module_id: None,
         };
 
         self.entries.insert(path.to_path_buf(), entry);
@@ -356,11 +582,17 @@ impl FileCache {
         self.entries.get(path).map(|e| e.content_hash)
     }
 
+    /// Get the interface fingerprint for a file.
+    pub fn get_interface_hash(&self, path: &Path) -> Option<ContentHash> {
+        self.entries.get(path).and_then(|e| e.interface_hash)
+    }
+
     /// Register definitions for a file.
     ///
     /// This maps a source file to the DefIds it produces during compilation.
     pub fn register_definitions(&mut self, path: &Path, defs: HashSet<DefId>) {
         if self.enabled {
+            self.stored_defs.remove(path);
             self.file_to_defs.insert(path.to_path_buf(), defs);
         }
     }
@@ -374,7 +606,16 @@ impl FileCache {
 
     /// Get all definitions from a file.
     pub fn get_definitions(&self, path: &Path) -> Option<&HashSet<DefId>> {
-        self.file_to_defs.get(path)
+        if let Some(defs) = self.file_to_defs.get(path) {
+            return Some(defs);
+        }
+        let stored = self.stored_defs.get(path)?;
+        Some(stored.decoded.get_or_init(|| {
+            self.defs_data[stored.offset..stored.offset + stored.count * 4]
+                .chunks_exact(4)
+                .map(|b| DefId::new(u32::from_le_bytes(b.try_into().expect("4 bytes"))))
+                .collect()
+        }))
     }
 
     /// Get the module ID for a file.
@@ -392,7 +633,7 @@ impl FileCache {
         for path in files {
             match self.check_file(path) {
                 FileStatus::Unchanged => {}
-                FileStatus::Modified | FileStatus::New => {
+                FileStatus::BodyModified | FileStatus::Modified | FileStatus::New => {
                     changed.push(path.clone());
                 }
                 FileStatus::Deleted => {
@@ -418,7 +659,7 @@ impl FileCache {
         let mut invalidated = HashSet::new();
 
         for path in changed_files {
-            if let Some(defs) = self.file_to_defs.get(path) {
+            if let Some(defs) = self.get_definitions(path) {
                 invalidated.extend(defs.iter().copied());
             }
         }
@@ -443,6 +684,7 @@ impl FileCache {
     pub fn remove_file(&mut self, path: &Path) {
         self.entries.remove(path);
         self.file_to_defs.remove(path);
+        self.stored_defs.remove(path);
         self.file_to_module.remove(path);
     }
 
@@ -450,6 +692,8 @@ impl FileCache {
     pub fn clear(&mut self) {
         self.entries.clear();
         self.file_to_defs.clear();
+        self.stored_defs.clear();
+        self.defs_data.clear();
         self.file_to_module.clear();
     }
 
@@ -478,6 +722,8 @@ pub struct FileCacheStats {
     pub unchanged: usize,
     /// Number of modified files.
     pub modified: usize,
+    /// Number of files with body-only modifications.
+    pub body_modified: usize,
     /// Number of new files.
     pub new_files: usize,
     /// Number of deleted files.
@@ -494,6 +740,7 @@ impl FileCache {
         for path in files {
             match self.check_file(path) {
                 FileStatus::Unchanged => stats.unchanged += 1,
+                FileStatus::BodyModified => stats.body_modified += 1,
                 FileStatus::Modified => stats.modified += 1,
                 FileStatus::New => stats.new_files += 1,
                 FileStatus::Deleted => stats.deleted += 1,
@@ -552,14 +799,88 @@ mod tests {
         // Update cache
         cache.update_file(&test_file).unwrap();
 
-        // Modify file
+        // Modify file's signature
         std::thread::sleep(std::time::Duration::from_millis(10));
-        fs::write(&test_file, "fn main() { 42 }").unwrap();
+        fs::write(&test_file, "fn main() -> i32 { 42 }").unwrap();
 
         // File should be modified
         assert_eq!(cache.check_file(&test_file), FileStatus::Modified);
     }
 
+    #[test]
+    fn test_file_cache_body_modified_file() {
+        let temp_dir = TempDir::new().unwrap();
+        let mut cache = FileCache::new(temp_dir.path().to_path_buf());
+        cache.init().unwrap();
+
+        let test_file = temp_dir.path().join("test.blood");
+        fs::write(&test_file, "pub fn f(x: i32) -> i32 / {IO} { x }").unwrap();
+        cache.update_file(&test_file).unwrap();
+
+        // Body and comment edits keep the interface
+        std::thread::sleep(std::time::Duration::from_millis(10));
+        fs::write(
+            &test_file,
+            "// doubled\npub fn f(x: i32) -> i32 / {IO} {\n    x * 2\n}\n",
+        )
+        .unwrap();
+        assert_eq!(cache.check_file(&test_file), FileStatus::BodyModified);
+
+        // Effect row edits change it
+        fs::write(&test_file, "pub fn f(x: i32) -> i32 / pure { x * 2 }").unwrap();
+        assert_eq!(cache.check_file(&test_file), FileStatus::Modified);
+
+        // So do body edits of an unannotated function, whose row is inferred
+        cache.update_file(&test_file).unwrap();
+        fs::write(&test_file, "pub fn f(x: i32) -> i32 { x }").unwrap();
+        cache.update_file(&test_file).unwrap();
+        fs::write(&test_file, "pub fn f(x: i32) -> i32 { x * 2 }").unwrap();
+        assert_eq!(cache.check_file(&test_file), FileStatus::Modified);
+    }
+
+    #[test]
+    fn test_interface_fingerprint() {
+        let fp = |src: &str| interface_fingerprint(src).unwrap();
+
+        // Bodies of effect-annotated functions and methods are not part of
+        // the interface
+        assert_eq!(
+            fp("fn f() -> i32 / pure { 1 }"),
+            fp("fn f() -> i32 / pure { 2 + 3 }")
+        );
+        assert_eq!(
+            fp("struct S {} impl S { fn get(&self) -> i32 / pure { 1 } }"),
+            fp("struct S {} impl S { fn get(&self) -> i32 / pure { 7 } }")
+        );
+
+        // Signatures, visibility and type declarations are
+        assert_ne!(
+            fp("fn f() -> i32 / pure { 1 }"),
+            fp("fn f() -> i64 / pure { 1 }")
+        );
+        assert_ne!(fp("fn f() / pure {}"), fp("pub fn f() / pure {}"));
+        assert_ne!(fp("struct S { a: i32 }"), fp("struct S { a: i64 }"));
+
+        // Generic and const bodies are instantiated by callers
+        assert_ne!(
+            fp("fn id<T>(x: T) -> T { x }"),
+            fp("fn id<T>(y: T) -> T { y }")
+        );
+        assert_ne!(
+            fp("const fn c() -> i32 { 1 }"),
+            fp("const fn c() -> i32 { 2 }")
+        );
+
+        // Unannotated bodies determine the inferred effect row
+        assert_ne!(
+            fp("effect Counter { op inc() -> i32; } pub fn f() -> i32 { 1 }"),
+            fp("effect Counter { op inc() -> i32; } pub fn f() -> i32 { perform Counter.inc() }")
+        );
+
+        // Unparseable sources have no fingerprint
+        assert!(interface_fingerprint("fn f( {").is_none());
+    }
+
     #[test]
     fn test_file_cache_deleted_file() {
         let temp_dir = TempDir::new().unwrap();
@@ -614,9 +935,74 @@ mod tests {
             let defs = cache.get_definitions(&test_file).unwrap();
             assert!(defs.contains(&DefId::new(0)));
             assert!(defs.contains(&DefId::new(1)));
+
+            // Interface fingerprint should be restored
+            assert_eq!(
+                cache.get_interface_hash(&test_file),
+                interface_fingerprint("fn main() {}")
+            );
         }
     }
 
+    #[test]
+    fn test_file_cache_resave_keeps_unread_definitions() {
+        let temp_dir = TempDir::new().unwrap();
+
+        let file1 = temp_dir.path().join("file1.blood");
+        let file2 = temp_dir.path().join("file2.blood");
+        fs::write(&file1, "fn f1() {}").unwrap();
+        fs::write(&file2, "fn f2() {}").unwrap();
+
+        {
+            let mut cache = FileCache::new(temp_dir.path().to_path_buf());
+            cache.init().unwrap();
+            cache.update_file(&file1).unwrap();
+            cache.update_file(&file2).unwrap();
+            cache.register_definitions(&file1, HashSet::from([DefId::new(3)]));
+            cache.register_definitions(&file2, HashSet::from([DefId::new(4), DefId::new(5)]));
+            cache.save().unwrap();
+        }
+
+        // Re-save after touching only file1; file2's list is copied undecoded
+        {
+            let mut cache = FileCache::new(temp_dir.path().to_path_buf());
+            assert!(cache.load().unwrap());
+            cache.register_definitions(&file1, HashSet::from([DefId::new(6)]));
+            cache.save().unwrap();
+        }
+
+        let mut cache = FileCache::new(temp_dir.path().to_path_buf());
+        assert!(cache.load().unwrap());
+        assert_eq!(
+            cache.get_definitions(&file1),
+            Some(&HashSet::from([DefId::new(6)]))
+        );
+        assert_eq!(
+            cache.get_definitions(&file2),
+            Some(&HashSet::from([DefId::new(4), DefId::new(5)]))
+        );
+    }
+
+    #[test]
+    fn test_file_cache_rejects_malformed_file() {
+        let temp_dir = TempDir::new().unwrap();
+        let blood_dir = temp_dir.path().join(".blood");
+        fs::create_dir_all(&blood_dir).unwrap();
+
+        let mut cache = FileCache::new(temp_dir.path().to_path_buf());
+
+        fs::write(blood_dir.join("file_cache.bin"), b"{}").unwrap();
+        assert!(matches!(cache.load(), Err(FileCacheError::Format(_))));
+
+        // Valid header claiming an entry that is not there
+        let mut data = FILE_CACHE_MAGIC.to_vec();
+        data.extend_from_slice(&FILE_CACHE_VERSION.to_le_bytes());
+        data.extend_from_slice(&1u32.to_le_bytes());
+        data.extend_from_slice(&0u32.to_le_bytes());
+        fs::write(blood_dir.join("file_cache.bin"), data).unwrap();
+        assert!(matches!(cache.load(), Err(FileCacheError::Format(_))));
+    }
+
     #[test]
     fn test_file_cache_find_changed_files() {
         let temp_dir = TempDir::new().unwrap();
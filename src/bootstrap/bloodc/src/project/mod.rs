@@ -15,7 +15,9 @@ mod resolve;
 pub use compiler::{
     IncrementalAnalysis, IncrementalStats, ProjectCompiler, ProjectCompilerBuilder,
 };
-pub use file_cache::{FileCache, FileCacheEntry, FileCacheError, FileCacheStats, FileStatus};
+pub use file_cache::{
+    interface_fingerprint, FileCache, FileCacheEntry, FileCacheError, FileCacheStats, FileStatus,
+};
 pub use graph::{DependencyGraph, GraphError};
 pub use manifest::{
     BinTarget, Dependency, DetailedDependency, Edition, LibTarget, Manifest, ManifestError, Package,
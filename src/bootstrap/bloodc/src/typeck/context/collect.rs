@@ -238,6 +238,53 @@ impl<'a> TypeContext<'a> {
         self.box_def_id == Some(def_id) || self.vec_def_id == Some(def_id)
     }
 
+    /// Locate and parse the stdlib prelude, interning its symbols into
+    /// `interner`, which is handed back either way.
+    ///
+    /// Returns `None` if there is no prelude file or it cannot be read or
+    /// parsed; having no prelude is valid.
+    pub fn parse_prelude(
+        stdlib_path: &Path,
+        interner: DefaultStringInterner,
+    ) -> (Option<ast::Program>, DefaultStringInterner) {
+        let prelude_file = match Self::find_prelude_file(stdlib_path) {
+            Some(p) => p,
+            None => return (None, interner),
+        };
+
+        // Read and parse the prelude file
+        let prelude_source = match std::fs::read_to_string(&prelude_file) {
+            Ok(s) => s,
+            Err(_) => return (None, interner), // Can't read prelude, silently continue
+        };
+
+        let mut parser = crate::parser::Parser::with_interner(&prelude_source, interner);
+        let prelude_ast = parser.parse_program();
+        let interner = parser.take_interner();
+        // A parse error in the prelude is not reported here either
+        (prelude_ast.ok(), interner)
+    }
+
+    /// Find the prelude file: `prelude.blood`, then `prelude/mod.blood`, in
+    /// the stdlib directory (or next to it, if `stdlib_path` is a file such
+    /// as `std.blood`).
+    fn find_prelude_file(stdlib_path: &Path) -> Option<PathBuf> {
+        let dir = if stdlib_path.is_file() {
+            stdlib_path.parent()?
+        } else {
+            stdlib_path
+        };
+        let prelude_path = dir.join("prelude.blood");
+        let alt_path = dir.join("prelude").join("mod.blood");
+        if prelude_path.exists() {
+            Some(prelude_path)
+        } else if alt_path.exists() {
+            Some(alt_path)
+        } else {
+            None // No prelude file found, that's fine
+        }
+    }
+
     /// Import prelude items from the standard library.
     ///
     /// This automatically imports commonly used items so they're available
@@ -245,8 +292,8 @@ impl<'a> TypeContext<'a> {
     /// is specified.
     ///
     /// The prelude is loaded from `prelude.blood` or `prelude/mod.blood` in the
-    /// stdlib path. All public items from the prelude are imported into the
-    /// global scope.
+    /// stdlib path, unless one was supplied with [`TypeContext::with_prelude`].
+    /// All public items from the prelude are imported into the global scope.
     ///
     /// If no stdlib_path is set or the prelude doesn't exist, this silently
     /// succeeds (having no prelude is valid).
@@ -255,59 +302,24 @@ impl<'a> TypeContext<'a> {
         // available through builtin function registration in TypeContext::new().
         // The prelude adds standard library types and traits.
 
-        // Check if stdlib_path is set
-        let stdlib_path = match &self.stdlib_path {
-            Some(p) => p.clone(),
-            None => return, // No stdlib configured, nothing to import
-        };
-
-        // Look for prelude file: try prelude.blood, then prelude/mod.blood
-        let prelude_file = if stdlib_path.is_file() {
-            // stdlib_path points to a single file (e.g., std.blood)
-            // Look for prelude.blood in the same directory
-            if let Some(parent) = stdlib_path.parent() {
-                let prelude_path = parent.join("prelude.blood");
-                let alt_path = parent.join("prelude").join("mod.blood");
-                if prelude_path.exists() {
-                    prelude_path
-                } else if alt_path.exists() {
-                    alt_path
-                } else {
-                    return; // No prelude file found, that's fine
+        let prelude_ast: Arc<ast::Program> = match &self.prelude {
+            Some(prelude) => Arc::clone(prelude),
+            None => {
+                // Check if stdlib_path is set
+                let stdlib_path = match &self.stdlib_path {
+                    Some(p) => p.clone(),
+                    None => return, // No stdlib configured, nothing to import
+                };
+                let interner = std::mem::take(&mut self.interner);
+                let (parsed, interner) = Self::parse_prelude(&stdlib_path, interner);
+                self.interner = interner;
+                match parsed {
+                    Some(ast) => Arc::new(ast),
+                    None => return,
                 }
-            } else {
-                return;
-            }
-        } else {
-            // stdlib_path is a directory
-            let prelude_path = stdlib_path.join("prelude.blood");
-            let alt_path = stdlib_path.join("prelude").join("mod.blood");
-            if prelude_path.exists() {
-                prelude_path
-            } else if alt_path.exists() {
-                alt_path
-            } else {
-                return; // No prelude file found, that's fine
             }
         };
 
-        // Read and parse the prelude file
-        let prelude_source = match std::fs::read_to_string(&prelude_file) {
-            Ok(s) => s,
-            Err(_) => return, // Can't read prelude, silently continue
-        };
-
-        // Parse the prelude
-        let interner = std::mem::take(&mut self.interner);
-        let mut parser = crate::parser::Parser::with_interner(&prelude_source, interner);
-        let prelude_ast = parser.parse_program();
-        self.interner = parser.take_interner();
-
-        let prelude_ast = match prelude_ast {
-            Ok(ast) => ast,
-            Err(_) => return, // Parse error in prelude, silently continue
-        };
-
         // Collect prelude declarations in a temporary scope, then re-export to global
         // This ensures proper DefId assignment while making items globally available
         let prelude_span = crate::span::Span::new(0, 0, 0, 0);
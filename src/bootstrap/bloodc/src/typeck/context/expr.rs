@@ -9114,9 +9114,10 @@ impl<'a> TypeContext<'a> {
         }
 
         // Check for exhaustiveness
-        let enum_info = self.get_enum_variant_info(&scrutinee_expr.ty);
         let result =
-            exhaustiveness::check_exhaustiveness(&hir_arms, &scrutinee_expr.ty, enum_info.as_ref());
+            exhaustiveness::check_exhaustiveness_with(&hir_arms, &scrutinee_expr.ty, &|ty| {
+                self.get_enum_variant_info(ty)
+            });
 
         if !result.is_exhaustive {
             return Err(Box::new(TypeError::new(
@@ -9195,9 +9196,10 @@ impl<'a> TypeContext<'a> {
         }
 
         // Check for exhaustiveness
-        let enum_info = self.get_enum_variant_info(&scrutinee_expr.ty);
         let result =
-            exhaustiveness::check_exhaustiveness(&hir_arms, &scrutinee_expr.ty, enum_info.as_ref());
+            exhaustiveness::check_exhaustiveness_with(&hir_arms, &scrutinee_expr.ty, &|ty| {
+                self.get_enum_variant_info(ty)
+            });
 
         if !result.is_exhaustive {
             return Err(Box::new(TypeError::new(
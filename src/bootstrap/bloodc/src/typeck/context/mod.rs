@@ -5,6 +5,7 @@
 
 use std::collections::HashMap;
 use std::path::PathBuf;
+use std::sync::Arc;
 
 use string_interner::{DefaultStringInterner, Symbol as _};
 
@@ -37,6 +38,8 @@ pub struct TypeContext<'a> {
     pub(crate) stdlib_path: Option<PathBuf>,
     /// Whether to disable automatic standard library prelude imports.
     pub(crate) no_std: bool,
+    /// A prelude parsed ahead of time (see [`TypeContext::with_prelude`]).
+    pub(crate) prelude: Option<Arc<ast::Program>>,
     /// The string interner for resolving symbols.
     pub(crate) interner: DefaultStringInterner,
     /// The name resolver.
@@ -716,6 +719,7 @@ impl<'a> TypeContext<'a> {
             source_path: None,
             stdlib_path: None,
             no_std: false,
+            prelude: None,
             interner,
             resolver: Resolver::new(source),
             unifier: Unifier::new(),
@@ -810,6 +814,15 @@ impl<'a> TypeContext<'a> {
         self
     }
 
+    /// Import `prelude` instead of reading and parsing the stdlib prelude
+    /// file. Its symbols must belong to the interner this context was
+    /// created with: parse it with [`TypeContext::parse_prelude`] and
+    /// start each source's parse from a clone of the resulting interner.
+    pub fn with_prelude(mut self, prelude: Arc<ast::Program>) -> Self {
+        self.prelude = Some(prelude);
+        self
+    }
+
     /// Build a mapping from DefId to human-readable type name for diagnostic display.
     ///
     /// Collects names from struct, enum, trait, and effect definitions so that
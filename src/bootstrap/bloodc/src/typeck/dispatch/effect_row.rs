@@ -3,9 +3,12 @@
 use std::cmp::Ordering;
 
 /// An effect row for effect-aware dispatch.
+///
+/// The constructors sort and deduplicate `effects`; subset and specificity
+/// checks rely on that order.
 #[derive(Debug, Clone, PartialEq, Eq)]
 pub struct EffectRow {
-    /// The effects in this row.
+    /// The effects in this row, sorted and without duplicates.
     pub effects: Vec<String>,
     /// Whether this is an open row (has a row variable).
     pub is_open: bool,
@@ -23,7 +26,7 @@ impl EffectRow {
     /// Create an effect row with the given effects.
     pub fn with_effects(effects: Vec<String>) -> Self {
         Self {
-            effects,
+            effects: canonical(effects),
             is_open: false,
         }
     }
@@ -31,7 +34,7 @@ impl EffectRow {
     /// Create an open effect row with a row variable.
     pub fn open(effects: Vec<String>) -> Self {
         Self {
-            effects,
+            effects: canonical(effects),
             is_open: true,
         }
     }
@@ -53,9 +56,14 @@ impl EffectRow {
     /// - An open row {A | rho} is compatible with any superset of {A}
     /// - A closed row {A, B} requires exactly those effects to be handled
     pub fn is_subset_of(&self, other: &EffectRow) -> bool {
-        // Check that all effects in self are present in other
+        // Check that all effects in self are present in other. Both rows
+        // are sorted, so a single merge walk over other suffices.
+        if self.effects.len() > other.effects.len() {
+            return false;
+        }
+        let mut theirs = other.effects.iter();
         for effect in &self.effects {
-            if !other.effects.contains(effect) {
+            if !theirs.by_ref().any(|candidate| candidate == effect) {
                 return false;
             }
         }
@@ -109,18 +117,14 @@ impl EffectRow {
         }
 
         // Rule 4: Same count, compare lexicographically for determinism
-        let mut self_sorted: Vec<_> = self.effects.iter().collect();
-        let mut other_sorted: Vec<_> = other.effects.iter().collect();
-        self_sorted.sort();
-        other_sorted.sort();
-
-        for (s, o) in self_sorted.iter().zip(other_sorted.iter()) {
-            match s.cmp(o) {
-                Ordering::Equal => continue,
-                ord => return ord,
-            }
-        }
-
-        Ordering::Equal
+        // (rows are already sorted)
+        self.effects.cmp(&other.effects)
     }
 }
+
+/// Sorts and deduplicates effect names.
+fn canonical(mut effects: Vec<String>) -> Vec<String> {
+    effects.sort_unstable();
+    effects.dedup();
+    effects
+}
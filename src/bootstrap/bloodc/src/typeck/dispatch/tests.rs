@@ -597,6 +597,20 @@ fn test_effect_row_with_effects() {
     assert!(!row.is_open);
 }
 
+#[test]
+fn test_effect_row_canonical_order() {
+    let row = EffectRow::with_effects(vec![
+        "IO".to_string(),
+        "Error".to_string(),
+        "IO".to_string(),
+    ]);
+    assert_eq!(row.effects, vec!["Error".to_string(), "IO".to_string()]);
+    assert_eq!(
+        row,
+        EffectRow::with_effects(vec!["Error".to_string(), "IO".to_string()])
+    );
+}
+
 #[test]
 fn test_effect_row_open() {
     let row = EffectRow::open(vec!["IO".to_string()]);
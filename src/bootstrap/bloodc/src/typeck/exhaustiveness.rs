@@ -2,15 +2,39 @@
 //!
 //! This module implements exhaustiveness and usefulness checking for match patterns.
 //! It detects:
-//! - Non-exhaustive matches (missing patterns)
+//! - Non-exhaustive matches (missing patterns, reported as witness values)
 //! - Unreachable patterns (dead code)
 //!
-//! The algorithm is based on the "usefulness" algorithm from Maranget's paper
-//! "Warnings for Pattern Matching" (JFP 2007), simplified for Blood's pattern language.
+//! The algorithm is the usefulness algorithm from Maranget's paper
+//! "Warnings for Pattern Matching" (JFP 2007), run once over the whole match:
+//!
+//! 1. Every arm pattern is lowered once into an arena of constructors
+//!    ([`Ctor`]) with sub-pattern lists. A matrix is one flat buffer of
+//!    arena indices, so specializing it copies indices, never patterns.
+//! 2. The first column is split into the constructors its patterns can tell
+//!    apart: enum variants, bools, disjoint integer ranges, slice lengths.
+//!    Rows are bucketed by the split constructors they match and each bucket
+//!    is specialized on demand; a column holding only wildcards is skipped
+//!    without looking at its type.
+//! 3. Once no columns remain, the first row left is useful. Arms none of
+//!    whose rows are ever useful are unreachable. A branch that no unguarded
+//!    row reaches produces a witness: a value that no arm matches.
+//! 4. Branches that cannot change the answer are cut short: rows below an
+//!    unguarded all-wildcard row are dropped, and when a column has missing
+//!    constructors only the default matrix is searched for witnesses (see
+//!    [`Row::relevant`]). This keeps sparse matches over many columns from
+//!    exploring every combination of values. A last column of integers is
+//!    decided piece by piece in one walk over its rows, without building a
+//!    matrix per piece.
+//!
+//! Guarded arms are checked for reachability but never count toward
+//! exhaustiveness, since the guard may fail.
 
-use std::collections::HashSet;
+use std::collections::HashMap;
 
-use crate::hir::{self, Pattern, PatternKind, Type, TypeKind};
+use crate::hir::{
+    self, DefId, IntTy, LiteralValue, Pattern, PatternKind, PrimitiveTy, Type, TypeKind, UintTy,
+};
 
 /// Result of exhaustiveness checking.
 #[derive(Debug)]
@@ -32,11 +56,37 @@ pub struct EnumVariantInfo {
     pub variant_names: Vec<String>,
 }
 
+/// Most witnesses kept per sub-problem. One is enough to reject a match;
+/// a few make a better error message.
+const MAX_WITNESSES: usize = 8;
+
 /// Check if a set of match arms is exhaustive for the given scrutinee type.
+///
+/// `enum_info` describes the scrutinee's enum, if it is one. Enums nested
+/// inside the patterns are treated as having only the variants that appear;
+/// use [`check_exhaustiveness_with`] to check those as well.
 pub fn check_exhaustiveness(
     arms: &[hir::MatchArm],
     scrutinee_ty: &Type,
     enum_info: Option<&EnumVariantInfo>,
+) -> ExhaustivenessResult {
+    let scrutinee_adt = adt_def_id(scrutinee_ty);
+    check_exhaustiveness_with(arms, scrutinee_ty, &|ty| {
+        if scrutinee_adt.is_some() && adt_def_id(ty) == scrutinee_adt {
+            enum_info.cloned()
+        } else {
+            None
+        }
+    })
+}
+
+/// Check if a set of match arms is exhaustive for the given scrutinee type,
+/// asking `enum_info` for the variants of every enum type the patterns
+/// match on, at any depth.
+pub fn check_exhaustiveness_with(
+    arms: &[hir::MatchArm],
+    scrutinee_ty: &Type,
+    enum_info: &dyn Fn(&Type) -> Option<EnumVariantInfo>,
 ) -> ExhaustivenessResult {
     if arms.is_empty() {
         // Empty match - exhaustive only if scrutinee is never type
@@ -55,684 +105,970 @@ pub fn check_exhaustiveness(
         };
     }
 
-    let patterns: Vec<_> = arms.iter().map(|a| &a.pattern).collect();
-
-    // Check for unreachable arms
-    let unreachable_arms = find_unreachable_arms(&patterns);
-
-    // Check exhaustiveness
-    let (is_exhaustive, missing) = is_exhaustive(&patterns, scrutinee_ty, enum_info);
+    let mut cx = MatchCheck::new(enum_info, arms.len());
+    let mut matrix = Matrix::new(1, true);
+    for (i, arm) in arms.iter().enumerate() {
+        let pat = cx.lower(&arm.pattern, Some(scrutinee_ty));
+        matrix.cells.push(pat);
+        matrix.rows.push(Row {
+            arm: i as u32,
+            guarded: arm.guard.is_some(),
+            relevant: true,
+        });
+    }
+    let witnesses = cx.usefulness(matrix);
+
+    let mut missing_patterns: Vec<String> = Vec::new();
+    for stack in &witnesses {
+        let text = stack
+            .first()
+            .map_or_else(|| "_".to_string(), |w| w.to_string());
+        if !missing_patterns.contains(&text) {
+            missing_patterns.push(text);
+        }
+    }
 
     ExhaustivenessResult {
-        is_exhaustive,
-        missing_patterns: missing,
-        unreachable_arms,
+        is_exhaustive: witnesses.is_empty(),
+        missing_patterns,
+        unreachable_arms: (0..arms.len()).filter(|&i| !cx.useful[i]).collect(),
     }
 }
 
-/// Check if a set of patterns is exhaustive for a type.
-fn is_exhaustive(
-    patterns: &[&Pattern],
-    scrutinee_ty: &Type,
-    enum_info: Option<&EnumVariantInfo>,
-) -> (bool, Vec<String>) {
-    // First check for wildcard or binding pattern that covers everything
-    for pat in patterns {
-        if is_irrefutable(pat) {
-            return (true, vec![]);
+/// Index of a lowered pattern in [`MatchCheck::pats`].
+type PatId = u32;
+
+/// The shared wildcard pattern, always at index 0.
+const WILD: PatId = 0;
+
+/// A value constructor, or a set of them, that a pattern tests for.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+enum Ctor {
+    /// Wildcards and bindings: every constructor.
+    Wild,
+    /// Or-pattern; its fields are the alternatives.
+    Or,
+    /// `true` or `false`.
+    Bool(bool),
+    /// Integers and chars in an inclusive range.
+    Range(i128, i128),
+    /// Enum variant by index.
+    Variant(u32),
+    /// The only constructor of a tuple or struct.
+    Single,
+    /// Slice or array of exactly this many elements.
+    FixedLen(u32),
+    /// Slice with a `..`: at least prefix + suffix elements.
+    VarLen(u32, u32),
+    /// A value from an open set (strings, floats), interned by value.
+    Opaque(u32),
+}
+
+/// A lowered pattern: its constructor and sub-patterns.
+#[derive(Debug, Clone, Copy)]
+struct DeconPat<'p> {
+    ctor: Ctor,
+    /// Sub-patterns, as `(field position, pattern)`, in
+    /// `MatchCheck::fields[start..end]`.
+    fields: (u32, u32),
+    /// Type of the matched value with references peeled, if known.
+    ty: Option<&'p Type>,
+}
+
+/// Bookkeeping for one matrix row.
+#[derive(Debug, Clone, Copy)]
+struct Row {
+    /// Index of the arm the row came from.
+    arm: u32,
+    /// Whether the arm has a guard, so it covers nothing.
+    guarded: bool,
+    /// Whether this branch can decide the row's usefulness. A row with a
+    /// wildcard head is useful under a present constructor only if it is
+    /// useful in the default matrix too, so only the default decides it.
+    relevant: bool,
+}
+
+/// A pattern matrix: one row per arm (or or-pattern alternative) still to
+/// be told apart, `width` patterns per row, stored row-major.
+#[derive(Debug, Clone)]
+struct Matrix {
+    width: usize,
+    cells: Vec<PatId>,
+    rows: Vec<Row>,
+    /// Whether the values this matrix misses are wanted. When a column has
+    /// missing constructors the default matrix alone decides whether the
+    /// match is exhaustive, so the present constructors' branches skip
+    /// witness construction.
+    witnesses: bool,
+}
+
+impl Matrix {
+    fn new(width: usize, witnesses: bool) -> Self {
+        Self {
+            width,
+            cells: Vec::new(),
+            rows: Vec::new(),
+            witnesses,
         }
     }
 
-    match &*scrutinee_ty.kind {
-        TypeKind::Primitive(hir::PrimitiveTy::Bool) => check_bool_exhaustiveness(patterns),
-        TypeKind::Adt { .. } => {
-            if let Some(info) = enum_info {
-                check_enum_exhaustiveness(patterns, info)
-            } else {
-                // Struct type - any pattern covers it (if no enum info provided)
-                (true, vec![])
+    fn row(&self, i: usize) -> &[PatId] {
+        &self.cells[i * self.width..(i + 1) * self.width]
+    }
+
+    fn head(&self, i: usize) -> PatId {
+        self.cells[i * self.width]
+    }
+}
+
+/// Value vectors, one entry per matrix column, that no row matches.
+type Witnesses = Vec<Vec<Witness>>;
+
+/// The constructors distinguished by one matrix column.
+struct Split<'p> {
+    /// Type of the column, if known.
+    ty: Option<&'p Type>,
+    /// Constructors matched by some row, with their arity.
+    present: Vec<(Ctor, usize)>,
+    /// Constructors of the type that no row names explicitly.
+    missing: Vec<Ctor>,
+    /// Bucket of each present range, sorted by start.
+    ranges: Vec<(i128, i128, usize)>,
+    /// Bucket of each present variant, by variant index.
+    variants: Vec<Option<usize>>,
+    /// Bucket of each present opaque value.
+    opaque: HashMap<Ctor, usize>,
+}
+
+impl Split<'_> {
+    /// Buckets whose constructor `ctor` covers.
+    fn buckets_of(&self, ctor: Ctor, out: &mut Vec<usize>) {
+        out.clear();
+        match ctor {
+            Ctor::Range(lo, hi) => {
+                let start = self.ranges.partition_point(|r| r.0 < lo);
+                for &(a, b, bucket) in &self.ranges[start..] {
+                    if a > hi {
+                        break;
+                    }
+                    if b <= hi {
+                        out.push(bucket);
+                    }
+                }
             }
-        }
-        TypeKind::Tuple(tys) => {
-            // Empty tuple is unit type - always exhaustive
-            if tys.is_empty() {
-                (true, vec![])
-            } else {
-                check_tuple_exhaustiveness(patterns, tys)
+            Ctor::FixedLen(_) | Ctor::VarLen(..) => {
+                for (bucket, &(split, _)) in self.present.iter().enumerate() {
+                    if slice_covers(ctor, split) {
+                        out.push(bucket);
+                    }
+                }
             }
-        }
-        TypeKind::Never => (true, vec![]),
-        TypeKind::Array { element, size } => {
-            // For fixed-size arrays, check if patterns cover all elements
-            let array_size = size.as_u64().unwrap_or(0);
-            check_array_exhaustiveness(patterns, element, array_size)
-        }
-        TypeKind::Ref { inner, .. } => {
-            // Look through references to check exhaustiveness of the inner type
-            is_exhaustive(patterns, inner, enum_info)
-        }
-        _ => {
-            // For other types (integers, strings, etc.), we can't check exhaustiveness
-            // without literal patterns, so we require a wildcard
-            (false, vec!["_".to_string()])
+            Ctor::Variant(idx) => out.extend(self.variants.get(idx as usize).copied().flatten()),
+            Ctor::Opaque(_) => out.extend(self.opaque.get(&ctor).copied()),
+            _ => out.extend(self.present.iter().position(|&(c, _)| c == ctor)),
         }
     }
 }
 
-/// Check if a pattern is irrefutable (always matches).
-fn is_irrefutable(pattern: &Pattern) -> bool {
-    match &pattern.kind {
-        PatternKind::Wildcard => true,
-        PatternKind::Binding { subpattern, .. } => {
-            subpattern.as_ref().map_or(true, |p| is_irrefutable(p))
-        }
-        PatternKind::Tuple(pats) => pats.iter().all(is_irrefutable),
-        PatternKind::Ref { inner, .. } => is_irrefutable(inner),
-        PatternKind::Struct { fields, .. } => fields.iter().all(|f| is_irrefutable(&f.pattern)),
-        PatternKind::Or(alts) => alts.iter().any(is_irrefutable),
-        // Slice is irrefutable only if it has a rest pattern and all subpatterns are irrefutable
-        PatternKind::Slice {
-            prefix,
-            slice,
-            suffix,
-        } => {
-            slice.is_some()
-                && prefix.iter().all(is_irrefutable)
-                && suffix.iter().all(is_irrefutable)
-                && slice.as_ref().map_or(true, |s| is_irrefutable(s))
-        }
-        // These patterns are always refutable (match specific values)
-        PatternKind::Literal(_) => false,
-        PatternKind::Variant { .. } => false,
-        PatternKind::Range { .. } => false,
+/// Whether slice pattern constructor `pat` matches every slice of `split`.
+fn slice_covers(pat: Ctor, split: Ctor) -> bool {
+    match (pat, split) {
+        (Ctor::FixedLen(k), Ctor::FixedLen(l)) => k == l,
+        (Ctor::VarLen(p, s), Ctor::FixedLen(l)) => p + s <= l,
+        (Ctor::VarLen(p, s), Ctor::VarLen(q, t)) => p <= q && s <= t,
+        _ => false,
     }
 }
 
-/// Check boolean exhaustiveness.
-fn check_bool_exhaustiveness(patterns: &[&Pattern]) -> (bool, Vec<String>) {
-    let mut has_true = false;
-    let mut has_false = false;
+/// State for checking one match.
+struct MatchCheck<'p, 'a> {
+    /// Pattern arena; `pats[WILD]` is the wildcard.
+    pats: Vec<DeconPat<'p>>,
+    /// Sub-pattern lists of `pats`.
+    fields: Vec<(u32, PatId)>,
+    /// Interned open-set literals.
+    opaque: HashMap<String, u32>,
+    /// Variant info per enum, looked up once.
+    enums: HashMap<DefId, Option<EnumVariantInfo>>,
+    enum_info: &'a dyn Fn(&Type) -> Option<EnumVariantInfo>,
+    /// Whether each arm is useful (reachable).
+    useful: Vec<bool>,
+    /// Uncovered values found so far; once there are enough, no branch
+    /// looks for more.
+    witnesses_found: usize,
+}
 
-    for pat in patterns {
+impl<'p, 'a> MatchCheck<'p, 'a> {
+    fn new(enum_info: &'a dyn Fn(&Type) -> Option<EnumVariantInfo>, arm_count: usize) -> Self {
+        Self {
+            pats: vec![DeconPat {
+                ctor: Ctor::Wild,
+                fields: (0, 0),
+                ty: None,
+            }],
+            fields: Vec::new(),
+            opaque: HashMap::new(),
+            enums: HashMap::new(),
+            enum_info,
+            useful: vec![false; arm_count],
+            witnesses_found: 0,
+        }
+    }
+
+    /// Lowers `pat` into the arena. `expected` is the type of the matched
+    /// value as known from the parent, used when `pat` carries no type.
+    fn lower(&mut self, pat: &'p Pattern, expected: Option<&'p Type>) -> PatId {
+        let ty = match pat.ty.kind() {
+            TypeKind::Error | TypeKind::Infer(_) => expected.map(peel),
+            _ => Some(peel(&pat.ty)),
+        };
         match &pat.kind {
-            // Wildcard covers all values
-            PatternKind::Wildcard => {
-                has_true = true;
-                has_false = true;
-            }
-            // Binding without subpattern covers all values
-            PatternKind::Binding {
+            PatternKind::Wildcard
+            | PatternKind::Binding {
                 subpattern: None, ..
-            } => {
-                has_true = true;
-                has_false = true;
-            }
-            // Binding with subpattern - check the subpattern
+            } => WILD,
             PatternKind::Binding {
                 subpattern: Some(sub),
                 ..
+            } => self.lower(sub, ty),
+            // References are transparent: `&p` matches what `p` matches.
+            PatternKind::Ref { inner, .. } => self.lower(inner, ty),
+            PatternKind::Literal(lit) => {
+                let ctor = self.literal_ctor(lit);
+                self.push(ctor, ty, Vec::new())
+            }
+            PatternKind::Range {
+                start,
+                end,
+                inclusive,
             } => {
-                if let PatternKind::Literal(hir::LiteralValue::Bool(b)) = &sub.kind {
-                    if *b {
-                        has_true = true;
-                    } else {
-                        has_false = true;
+                let (min, max) = ty.and_then(int_domain).unwrap_or((i128::MIN, i128::MAX));
+                let bound = |p: &Option<Box<Pattern>>| match p.as_deref().map(|p| &p.kind) {
+                    None => Some(None),
+                    Some(PatternKind::Literal(lit)) => literal_int(lit).map(Some),
+                    Some(_) => None,
+                };
+                let ctor = match (bound(start), bound(end)) {
+                    (Some(lo), Some(hi)) => {
+                        let lo = lo.unwrap_or(min);
+                        let hi = match hi {
+                            Some(hi) if !*inclusive => hi.saturating_sub(1),
+                            Some(hi) => hi,
+                            None => max,
+                        };
+                        Ctor::Range(lo, hi)
                     }
-                }
+                    // Non-literal bounds cannot be compared; treat the
+                    // range as a value of its own.
+                    _ => self.intern(format!("{:p}", pat)),
+                };
+                self.push(ctor, ty, Vec::new())
             }
-            PatternKind::Literal(hir::LiteralValue::Bool(true)) => has_true = true,
-            PatternKind::Literal(hir::LiteralValue::Bool(false)) => has_false = true,
-            PatternKind::Or(alts) => {
-                for alt in alts {
-                    match &alt.kind {
-                        PatternKind::Wildcard => {
-                            has_true = true;
-                            has_false = true;
-                        }
-                        PatternKind::Binding {
-                            subpattern: None, ..
-                        } => {
-                            has_true = true;
-                            has_false = true;
-                        }
-                        PatternKind::Literal(hir::LiteralValue::Bool(b)) => {
-                            if *b {
-                                has_true = true;
-                            } else {
-                                has_false = true;
-                            }
-                        }
-                        // These patterns don't contribute to bool exhaustiveness
-                        PatternKind::Literal(_)
-                        | PatternKind::Variant { .. }
-                        | PatternKind::Struct { .. }
-                        | PatternKind::Tuple(_)
-                        | PatternKind::Slice { .. }
-                        | PatternKind::Ref { .. }
-                        | PatternKind::Range { .. }
-                        | PatternKind::Or(_)
-                        | PatternKind::Binding {
-                            subpattern: Some(_),
-                            ..
-                        } => {}
+            PatternKind::Variant {
+                variant_idx,
+                fields,
+                ..
+            } => {
+                let fields = fields
+                    .iter()
+                    .enumerate()
+                    .map(|(i, f)| (i as u32, self.lower(f, None)))
+                    .collect();
+                self.push(Ctor::Variant(*variant_idx), ty, fields)
+            }
+            PatternKind::Struct { fields, .. } => {
+                let fields = fields
+                    .iter()
+                    .map(|f| (f.field_idx, self.lower(&f.pattern, None)))
+                    .collect();
+                self.push(Ctor::Single, ty, fields)
+            }
+            PatternKind::Tuple(pats) => {
+                let elem_tys = match ty.map(Type::kind) {
+                    Some(TypeKind::Tuple(tys)) => Some(tys),
+                    _ => None,
+                };
+                let fields = pats
+                    .iter()
+                    .enumerate()
+                    .map(|(i, p)| {
+                        let elem_ty = elem_tys.and_then(|tys| tys.get(i));
+                        (i as u32, self.lower(p, elem_ty))
+                    })
+                    .collect();
+                self.push(Ctor::Single, ty, fields)
+            }
+            PatternKind::Slice {
+                prefix,
+                slice,
+                suffix,
+            } => {
+                let elem_ty = match ty.map(Type::kind) {
+                    Some(TypeKind::Array { element, .. } | TypeKind::Slice { element }) => {
+                        Some(element)
                     }
-                }
+                    _ => None,
+                };
+                let prefix_len = prefix.len() as u32;
+                let suffix_len = suffix.len() as u32;
+                let ctor = if slice.is_some() {
+                    Ctor::VarLen(prefix_len, suffix_len)
+                } else {
+                    Ctor::FixedLen(prefix_len + suffix_len)
+                };
+                // The rest binding matches any sub-slice; only the
+                // prefix and suffix elements are tested.
+                let fields = prefix
+                    .iter()
+                    .chain(suffix)
+                    .enumerate()
+                    .map(|(i, p)| (i as u32, self.lower(p, elem_ty)))
+                    .collect();
+                self.push(ctor, ty, fields)
+            }
+            PatternKind::Or(alts) => {
+                let fields = alts
+                    .iter()
+                    .enumerate()
+                    .map(|(i, alt)| (i as u32, self.lower(alt, ty)))
+                    .collect();
+                self.push(Ctor::Or, ty, fields)
             }
-            // Other patterns (Literal non-bool, Struct, Tuple, etc.) don't match bool
-            PatternKind::Literal(_)
-            | PatternKind::Variant { .. }
-            | PatternKind::Struct { .. }
-            | PatternKind::Tuple(_)
-            | PatternKind::Slice { .. }
-            | PatternKind::Ref { .. }
-            | PatternKind::Range { .. } => {}
         }
     }
 
-    let mut missing = vec![];
-    if !has_true {
-        missing.push("true".to_string());
+    fn push(&mut self, ctor: Ctor, ty: Option<&'p Type>, fields: Vec<(u32, PatId)>) -> PatId {
+        let start = self.fields.len() as u32;
+        self.fields.extend(fields);
+        self.pats.push(DeconPat {
+            ctor,
+            fields: (start, self.fields.len() as u32),
+            ty,
+        });
+        (self.pats.len() - 1) as PatId
     }
-    if !has_false {
-        missing.push("false".to_string());
+
+    fn literal_ctor(&mut self, lit: &LiteralValue) -> Ctor {
+        match lit {
+            LiteralValue::Bool(b) => Ctor::Bool(*b),
+            _ => match literal_int(lit) {
+                Some(v) => Ctor::Range(v, v),
+                None => self.intern(format!("{:?}", lit)),
+            },
+        }
     }
 
-    (missing.is_empty(), missing)
-}
+    fn intern(&mut self, key: String) -> Ctor {
+        let next = self.opaque.len() as u32;
+        Ctor::Opaque(*self.opaque.entry(key).or_insert(next))
+    }
 
-/// Check enum exhaustiveness.
-fn check_enum_exhaustiveness(
-    patterns: &[&Pattern],
-    enum_info: &EnumVariantInfo,
-) -> (bool, Vec<String>) {
-    let mut covered_variants: HashSet<u32> = HashSet::new();
+    fn pat_fields(&self, pat: &DeconPat<'_>) -> &[(u32, PatId)] {
+        &self.fields[pat.fields.0 as usize..pat.fields.1 as usize]
+    }
 
-    for pat in patterns {
-        collect_variant_indices(pat, &mut covered_variants, enum_info.variant_count);
+    fn variant_info(&mut self, ty: &Type) -> Option<&EnumVariantInfo> {
+        let def_id = adt_def_id(ty)?;
+        let lookup = self.enum_info;
+        self.enums
+            .entry(def_id)
+            .or_insert_with(|| lookup(ty))
+            .as_ref()
     }
 
-    let mut missing = vec![];
-    for idx in 0..enum_info.variant_count {
-        if !covered_variants.contains(&idx) {
-            if let Some(name) = enum_info.variant_names.get(idx as usize) {
-                missing.push(name.clone());
-            } else {
-                missing.push(format!("variant {}", idx));
+    /// Marks the useful rows of `matrix` and returns the value vectors it
+    /// does not cover.
+    fn usefulness(&mut self, mut matrix: Matrix) -> Witnesses {
+        let width = matrix.width;
+        // Rows already known to be useful need no further work.
+        for row in &mut matrix.rows {
+            row.relevant &= !self.useful[row.arm as usize];
+        }
+        // An unguarded row of wildcards covers everything below it.
+        if let Some(cover) = (0..matrix.rows.len())
+            .find(|&i| !matrix.rows[i].guarded && matrix.row(i).iter().all(|&pat| pat == WILD))
+        {
+            matrix.rows.truncate(cover + 1);
+            matrix.cells.truncate((cover + 1) * width);
+        }
+        matrix.witnesses &= self.witnesses_found < MAX_WITNESSES;
+        if !matrix.witnesses {
+            // Only relevant rows and the rows above them matter now.
+            let Some(last) = matrix.rows.iter().rposition(|row| row.relevant) else {
+                return Vec::new();
+            };
+            matrix.rows.truncate(last + 1);
+            matrix.cells.truncate((last + 1) * width);
+        }
+        if width == 0 {
+            for row in &matrix.rows {
+                if row.relevant {
+                    self.useful[row.arm as usize] = true;
+                }
+                if !row.guarded {
+                    return Vec::new();
+                }
+            }
+            if !matrix.witnesses {
+                return Vec::new();
             }
+            self.witnesses_found += 1;
+            return vec![Vec::new()];
         }
-    }
 
-    (missing.is_empty(), missing)
-}
-
-/// Collect all variant indices covered by a pattern.
-///
-/// `variant_count` is the total number of variants in the enum, used when
-/// a wildcard pattern is encountered to mark all variants as covered.
-fn collect_variant_indices(pattern: &Pattern, indices: &mut HashSet<u32>, variant_count: u32) {
-    match &pattern.kind {
-        // Wildcard covers all variants
-        PatternKind::Wildcard => {
-            for idx in 0..variant_count {
-                indices.insert(idx);
-            }
-        }
-        // Binding without subpattern covers all variants
-        PatternKind::Binding {
-            subpattern: None, ..
-        } => {
-            for idx in 0..variant_count {
-                indices.insert(idx);
-            }
-        }
-        // Binding with subpattern - check the subpattern
-        PatternKind::Binding {
-            subpattern: Some(sub),
-            ..
-        } => {
-            collect_variant_indices(sub, indices, variant_count);
-        }
-        PatternKind::Variant { variant_idx, .. } => {
-            indices.insert(*variant_idx);
-        }
-        PatternKind::Or(alts) => {
-            for alt in alts {
-                collect_variant_indices(alt, indices, variant_count);
-            }
-        }
-        // Reference patterns - look through to the inner pattern
-        // This handles matching &Enum with &Enum::Variant patterns
-        PatternKind::Ref { inner, .. } => {
-            collect_variant_indices(inner, indices, variant_count);
-        }
-        // Other patterns don't match enum variants
-        PatternKind::Literal(_)
-        | PatternKind::Struct { .. }
-        | PatternKind::Tuple(_)
-        | PatternKind::Slice { .. }
-        | PatternKind::Range { .. } => {}
-    }
-}
-
-/// Check tuple exhaustiveness using pattern matrix specialization.
-///
-/// ## Algorithm
-///
-/// Uses a simplified Maranget-style algorithm that properly handles
-/// cross-position interactions for closed types (bool, enums, unit).
-/// Falls back to per-position checking when any element type is open
-/// (integers, strings, floats).
-///
-/// For closed types, the algorithm:
-/// 1. Build a pattern matrix from tuple patterns
-/// 2. Check if any row is irrefutable → exhaustive
-/// 3. Find the first column with a closed type
-/// 4. For each constructor of that type, specialize the matrix
-/// 5. Recursively check each specialized matrix
-/// 6. If all constructors lead to exhaustive sub-matrices → exhaustive
-///
-/// ## Examples
-///
-/// `(true, _), (false, _)` on `(bool, i32)` → exhaustive
-///   (wildcards in position 1 cover all i32 for both bool constructors)
-///
-/// `(true, true), (false, false)` on `(bool, bool)` → NOT exhaustive
-///   (specializing on `true` at position 0 gives `[true]` at position 1,
-///    specializing on `false` gives `[false]`, neither covers all bools)
-///
-/// `(true, _), (_, true)` on `(bool, bool)` → exhaustive
-///   (specializing on `true` at pos 0 gives `[_, true]` → wildcard covers;
-///    specializing on `false` gives `[true]` at pos 1 → not all bools...
-///    but the wildcard row `(_, true)` also matches `false` at pos 0)
-fn check_tuple_exhaustiveness(
-    patterns: &[&Pattern],
-    element_types: &[Type],
-) -> (bool, Vec<String>) {
-    if element_types.is_empty() {
-        return (true, vec![]);
-    }
+        let matrix = self.expand_or(matrix);
+        let row_count = matrix.rows.len();
+        // The column's kind comes from its first constructor, preferring
+        // one from a closed set over an opaque value.
+        let heads = || (0..row_count).map(|i| self.pats[matrix.head(i) as usize]);
+        let first = heads()
+            .find(|pat| !matches!(pat.ctor, Ctor::Wild | Ctor::Opaque(_)))
+            .or_else(|| heads().find(|pat| pat.ctor != Ctor::Wild));
+        let Some(first) = first else {
+            // Only wildcards: the column tells nothing apart.
+            let mut tails = Matrix::new(width - 1, matrix.witnesses);
+            for i in 0..row_count {
+                self.specialize_into(&mut tails, &matrix, i, Ctor::Wild, 0, true);
+            }
+            let mut witnesses = self.usefulness(tails);
+            for stack in &mut witnesses {
+                stack.insert(0, Witness::Wild);
+            }
+            return witnesses;
+        };
 
-    // Check if any pattern covers all tuple positions
-    for pat in patterns {
-        if is_irrefutable(pat) {
-            return (true, vec![]);
+        let split = self.split_column(&matrix, first);
+        if width == 1 && matches!(first.ctor, Ctor::Range(..)) {
+            return self.range_leaves(matrix, &split);
+        }
+        // With constructors missing, the default matrix decides both
+        // exhaustiveness and the wildcard rows; the present constructors'
+        // branches are only needed for rows that name them.
+        let complete = split.missing.is_empty();
+        let mut buckets: Vec<Matrix> = split
+            .present
+            .iter()
+            .map(|&(_, arity)| Matrix::new(arity + width - 1, matrix.witnesses && complete))
+            .collect();
+        let mut default = Matrix::new(width - 1, matrix.witnesses);
+        let mut matched = Vec::new();
+        for i in 0..row_count {
+            let head = self.pats[matrix.head(i) as usize];
+            if head.ctor == Ctor::Wild {
+                for (bucket, &(ctor, arity)) in split.present.iter().enumerate() {
+                    let out = &mut buckets[bucket];
+                    self.specialize_into(out, &matrix, i, ctor, arity, complete);
+                }
+                if !complete {
+                    self.specialize_into(&mut default, &matrix, i, Ctor::Wild, 0, true);
+                }
+            } else {
+                split.buckets_of(head.ctor, &mut matched);
+                for &bucket in &matched {
+                    let (ctor, arity) = split.present[bucket];
+                    let out = &mut buckets[bucket];
+                    self.specialize_into(out, &matrix, i, ctor, arity, true);
+                }
+            }
+        }
+        drop(matrix);
+
+        // Every bucket is visited even once witnesses are capped: the
+        // recursion is also what marks rows useful.
+        let mut witnesses = Vec::new();
+        for (bucket, sub) in buckets.into_iter().enumerate() {
+            let (ctor, arity) = split.present[bucket];
+            for mut stack in self.usefulness(sub) {
+                if witnesses.len() < MAX_WITNESSES {
+                    let fields = stack.drain(..arity).collect();
+                    stack.insert(0, self.witness(ctor, fields, split.ty));
+                    witnesses.push(stack);
+                }
+            }
+        }
+        if !complete {
+            for stack in self.usefulness(default) {
+                for &ctor in &split.missing {
+                    if witnesses.len() < MAX_WITNESSES {
+                        let mut stack = stack.clone();
+                        stack.insert(0, self.witness(ctor, Vec::new(), split.ty));
+                        witnesses.push(stack);
+                    }
+                }
+            }
         }
+        witnesses
     }
 
-    // Build the pattern matrix: each row is one tuple pattern's sub-patterns.
-    // Non-tuple patterns (wildcards, bindings) are expanded to rows of wildcards.
-    let matrix = build_tuple_matrix(patterns, element_types.len());
+    /// [`usefulness`](Self::usefulness) for a single column of integer
+    /// ranges, once split. Each piece's branch would be a matrix of empty
+    /// rows decided by its first unguarded row, so one walk over the rows
+    /// decides every piece; opcode tables split into hundreds of pieces.
+    fn range_leaves(&mut self, matrix: Matrix, split: &Split<'_>) -> Witnesses {
+        let complete = split.missing.is_empty();
+        let mut covered = vec![false; split.present.len()];
+        let mut open = covered.len();
+        let mut default = Matrix::new(0, matrix.witnesses);
+        let mut matched = Vec::new();
+        for (i, &row) in matrix.rows.iter().enumerate() {
+            let wild = matrix.head(i) == WILD;
+            if wild && !complete {
+                default.rows.push(row);
+            }
+            if open == 0 {
+                continue;
+            }
+            if wild {
+                matched.clear();
+                matched.extend(0..covered.len());
+            } else {
+                split.buckets_of(self.pats[matrix.head(i) as usize].ctor, &mut matched);
+            }
+            // As in the general case, a wildcard row is decided by the
+            // default matrix when constructors are missing.
+            let relevant = row.relevant && (complete || !wild);
+            for &bucket in &matched {
+                if covered[bucket] {
+                    continue;
+                }
+                if relevant {
+                    self.useful[row.arm as usize] = true;
+                }
+                if !row.guarded {
+                    covered[bucket] = true;
+                    open -= 1;
+                }
+            }
+        }
 
-    if matrix.is_empty() {
-        return (false, vec!["(_, ...)".to_string()]);
+        let mut witnesses = Vec::new();
+        if matrix.witnesses && complete {
+            for (bucket, &(ctor, _)) in split.present.iter().enumerate() {
+                if !covered[bucket] && self.witnesses_found < MAX_WITNESSES {
+                    self.witnesses_found += 1;
+                    witnesses.push(vec![self.witness(ctor, Vec::new(), split.ty)]);
+                }
+            }
+        }
+        if !complete {
+            for stack in self.usefulness(default) {
+                for &ctor in &split.missing {
+                    if witnesses.len() < MAX_WITNESSES {
+                        let mut stack = stack.clone();
+                        stack.insert(0, self.witness(ctor, Vec::new(), split.ty));
+                        witnesses.push(stack);
+                    }
+                }
+            }
+        }
+        witnesses
     }
 
-    // Check if any element type is closed (bool, enum with known variants).
-    // If all types are open, fall back to per-position checking.
-    let has_closed_type = element_types.iter().any(is_closed_type);
-
-    if has_closed_type {
-        // Use matrix specialization for proper cross-position analysis
-        let is_exhaustive = is_tuple_matrix_exhaustive(&matrix, element_types);
-        if is_exhaustive {
-            (true, vec![])
-        } else {
-            (false, vec!["non-exhaustive tuple patterns".to_string()])
+    /// Replaces rows starting with an or-pattern by one row per alternative.
+    fn expand_or(&self, matrix: Matrix) -> Matrix {
+        let is_or = |pat: PatId| self.pats[pat as usize].ctor == Ctor::Or;
+        if !(0..matrix.rows.len()).any(|i| is_or(matrix.head(i))) {
+            return matrix;
+        }
+        let mut expanded = Matrix::new(matrix.width, matrix.witnesses);
+        let mut pending = Vec::new();
+        for i in 0..matrix.rows.len() {
+            pending.push(matrix.head(i));
+            while let Some(head) = pending.pop() {
+                if is_or(head) {
+                    // Pushed in reverse so alternatives come out in order.
+                    let alts = self.pat_fields(&self.pats[head as usize]);
+                    pending.extend(alts.iter().rev().map(|&(_, alt)| alt));
+                } else {
+                    expanded.cells.push(head);
+                    expanded.cells.extend_from_slice(&matrix.row(i)[1..]);
+                    expanded.rows.push(matrix.rows[i]);
+                }
+            }
         }
-    } else {
-        // All open types: per-position check is correct
-        // (no finite set of constructors to enumerate)
-        check_tuple_per_position(&matrix, element_types)
+        expanded
     }
-}
 
-/// Build a pattern matrix from tuple patterns.
-///
-/// Each row contains `arity` patterns. Wildcard/binding patterns at the
-/// tuple level are expanded to a row of wildcards.
-fn build_tuple_matrix(patterns: &[&Pattern], arity: usize) -> Vec<Vec<Pattern>> {
-    let mut matrix = Vec::new();
-    let wildcard = || Pattern {
-        kind: PatternKind::Wildcard,
-        span: crate::span::Span::dummy(),
-        ty: Type::error(),
-    };
+    /// Splits the first column of `matrix` into the constructors it can
+    /// tell apart. `first` is the column's first non-wildcard pattern.
+    fn split_column(&mut self, matrix: &Matrix, first: DeconPat<'p>) -> Split<'p> {
+        let heads: Vec<DeconPat<'p>> = (0..matrix.rows.len())
+            .map(|i| self.pats[matrix.head(i) as usize])
+            .filter(|pat| pat.ctor != Ctor::Wild)
+            .collect();
+        let mut split = Split {
+            ty: first.ty,
+            present: Vec::new(),
+            missing: Vec::new(),
+            ranges: Vec::new(),
+            variants: Vec::new(),
+            opaque: HashMap::new(),
+        };
 
-    for pat in patterns {
-        match &pat.kind {
-            PatternKind::Tuple(pats) => {
-                if pats.len() == arity {
-                    matrix.push(pats.clone());
+        match first.ctor {
+            Ctor::Bool(_) => {
+                for b in [true, false] {
+                    if heads.iter().any(|pat| pat.ctor == Ctor::Bool(b)) {
+                        split.present.push((Ctor::Bool(b), 0));
+                    } else {
+                        split.missing.push(Ctor::Bool(b));
+                    }
                 }
-                // Mismatched arity is a type error; skip silently
-            }
-            PatternKind::Wildcard
-            | PatternKind::Binding {
-                subpattern: None, ..
-            } => {
-                // Expand to a row of wildcards
-                matrix.push(vec![wildcard(); arity]);
             }
-            PatternKind::Binding {
-                subpattern: Some(sub),
-                ..
-            } => {
-                // Recurse into the sub-pattern
-                let sub_refs: Vec<&Pattern> = vec![sub.as_ref()];
-                let sub_matrix = build_tuple_matrix(&sub_refs, arity);
-                matrix.extend(sub_matrix);
+            Ctor::Variant(_) => {
+                let mut seen: Vec<(u32, usize)> = heads
+                    .iter()
+                    .filter_map(|pat| match pat.ctor {
+                        Ctor::Variant(idx) => Some((idx, self.pat_fields(pat).len())),
+                        _ => None,
+                    })
+                    .collect();
+                // Sorted by variant, widest first, so dedup keeps the arity.
+                seen.sort_unstable_by(|a, b| a.0.cmp(&b.0).then(b.1.cmp(&a.1)));
+                seen.dedup_by_key(|entry| entry.0);
+                // Without variant info only the named variants are known.
+                let count = split
+                    .ty
+                    .and_then(|ty| self.variant_info(ty))
+                    .map(|info| info.variant_count);
+                for idx in 0..count.unwrap_or(0) {
+                    if seen.binary_search_by_key(&idx, |&(v, _)| v).is_err() {
+                        split.missing.push(Ctor::Variant(idx));
+                    }
+                }
+                split.present.extend(
+                    seen.into_iter()
+                        .map(|(idx, arity)| (Ctor::Variant(idx), arity)),
+                );
             }
-            PatternKind::Or(alts) => {
-                // Each alternative adds a row
-                let alt_refs: Vec<&Pattern> = alts.iter().collect();
-                let sub_matrix = build_tuple_matrix(&alt_refs, arity);
-                matrix.extend(sub_matrix);
+            Ctor::Range(..) => self.split_ranges(&heads, &mut split),
+            Ctor::Single => {
+                let mut arity = match split.ty.map(Type::kind) {
+                    Some(TypeKind::Tuple(tys)) => tys.len(),
+                    _ => 0,
+                };
+                for pat in &heads {
+                    if let Some(&(pos, _)) = self.pat_fields(pat).iter().max() {
+                        arity = arity.max(pos as usize + 1);
+                    }
+                }
+                split.present.push((Ctor::Single, arity));
             }
-            _ => {
-                // Non-tuple pattern in tuple context; skip
+            Ctor::FixedLen(_) | Ctor::VarLen(..) => {
+                for ctor in slice_ctors(&heads, split.ty) {
+                    let arity = match ctor {
+                        Ctor::FixedLen(len) => len as usize,
+                        Ctor::VarLen(prefix, suffix) => (prefix + suffix) as usize,
+                        _ => 0,
+                    };
+                    if heads.iter().any(|pat| slice_covers(pat.ctor, ctor)) {
+                        split.present.push((ctor, arity));
+                    } else {
+                        split.missing.push(ctor);
+                    }
+                }
             }
+            Ctor::Opaque(_) | Ctor::Wild | Ctor::Or => {}
         }
-    }
-    matrix
-}
 
-/// Check if a type has a finite, known set of constructors.
-fn is_closed_type(ty: &Type) -> bool {
-    matches!(
-        &*ty.kind,
-        TypeKind::Primitive(hir::PrimitiveTy::Bool)
-        | TypeKind::Tuple(_)  // unit () is the only 0-element constructor
-        | TypeKind::Never
-    )
-    // Note: ADT/enum types would also be closed, but we'd need EnumVariantInfo
-    // to enumerate constructors. For now, only bool is fully supported as closed.
-}
-
-/// Get the constructors for a closed type.
-///
-/// Returns a list of "constructor tags" that can be matched against patterns.
-/// For bool: `[true, false]`
-fn closed_type_constructors(ty: &Type) -> Vec<ConstructorTag> {
-    match &*ty.kind {
-        TypeKind::Primitive(hir::PrimitiveTy::Bool) => {
-            vec![ConstructorTag::BoolTrue, ConstructorTag::BoolFalse]
+        for (bucket, &(ctor, _)) in split.present.iter().enumerate() {
+            match ctor {
+                Ctor::Range(lo, hi) => split.ranges.push((lo, hi, bucket)),
+                Ctor::Variant(idx) => {
+                    let idx = idx as usize;
+                    if split.variants.len() <= idx {
+                        split.variants.resize(idx + 1, None);
+                    }
+                    split.variants[idx] = Some(bucket);
+                }
+                _ => {}
+            }
         }
-        TypeKind::Never => vec![], // No constructors — always exhaustive
-        _ => vec![],               // Open type or unsupported — no constructors
-    }
-}
 
-/// A tag identifying a constructor for specialization.
-#[derive(Debug, Clone, PartialEq, Eq)]
-enum ConstructorTag {
-    BoolTrue,
-    BoolFalse,
-}
-
-/// Check if the matrix of patterns is exhaustive for the given tuple types.
-///
-/// Implements a simplified Maranget-style algorithm:
-/// 1. If no columns remain, exhaustive iff at least one row exists
-/// 2. If any row is all-wildcards, exhaustive
-/// 3. Find first closed-type column
-/// 4. For each constructor of that type, specialize and recurse
-fn is_tuple_matrix_exhaustive(matrix: &[Vec<Pattern>], types: &[Type]) -> bool {
-    // Base case: no columns left — exhaustive if matrix has at least one row
-    if types.is_empty() {
-        return !matrix.is_empty();
-    }
-
-    // Check if any row is all irrefutable
-    for row in matrix {
-        if row.iter().all(|p| is_irrefutable(p)) {
-            return true;
+        // Open-set values never cover their type.
+        for pat in &heads {
+            if let Ctor::Opaque(_) = pat.ctor {
+                if !split.opaque.contains_key(&pat.ctor) {
+                    split.opaque.insert(pat.ctor, split.present.len());
+                    split.present.push((pat.ctor, 0));
+                }
+                if !split.missing.contains(&Ctor::Wild) {
+                    split.missing.push(Ctor::Wild);
+                }
+            }
         }
+        split
     }
 
-    // Find the first column with a closed type for specialization
-    let closed_col = types.iter().position(|t| {
-        let ctors = closed_type_constructors(t);
-        !ctors.is_empty()
-    });
-
-    if let Some(col) = closed_col {
-        let constructors = closed_type_constructors(&types[col]);
+    /// Cuts the type's integer domain at every range boundary in the
+    /// column, so each piece is either inside or outside every range.
+    fn split_ranges(&self, heads: &[DeconPat<'_>], split: &mut Split<'_>) {
+        let domain = split.ty.and_then(int_domain);
+        let (min, max) = domain.unwrap_or((i128::MIN, i128::MAX));
+        let hole = split.ty.and_then(int_domain_hole);
+
+        // Pieces are cut around the values the type cannot hold.
+        let mut emit = |lo: i128, hi: i128, covered: bool| {
+            let parts = match hole {
+                Some((a, b)) if lo <= b && hi >= a => [(lo, a - 1), (b + 1, hi)],
+                _ => [(lo, hi), (1, 0)],
+            };
+            for (lo, hi) in parts.into_iter().filter(|&(lo, hi)| lo <= hi) {
+                if covered {
+                    split.present.push((Ctor::Range(lo, hi), 0));
+                } else if domain.is_some() {
+                    split.missing.push(Ctor::Range(lo, hi));
+                }
+            }
+        };
 
-        // For each constructor, specialize the matrix and check recursively
-        for ctor in &constructors {
-            let specialized = specialize_matrix(matrix, col, ctor);
-            let remaining_types: Vec<Type> = types
+        if heads
+            .iter()
+            .all(|pat| matches!(pat.ctor, Ctor::Range(lo, hi) if lo == hi))
+        {
+            // Literals only, as in opcode tables: sort the values and walk
+            // the gaps between them. A dense column has no gaps, so nothing
+            // is missing.
+            let mut values: Vec<i128> = heads
                 .iter()
-                .enumerate()
-                .filter(|(i, _)| *i != col)
-                .map(|(_, t)| t.clone())
+                .filter_map(|pat| match pat.ctor {
+                    Ctor::Range(v, _) if (min..=max).contains(&v) => Some(v),
+                    _ => None,
+                })
                 .collect();
-
-            if !is_tuple_matrix_exhaustive(&specialized, &remaining_types) {
-                return false;
+            values.sort_unstable();
+            values.dedup();
+            let mut next = Some(min);
+            for v in values {
+                let start = next.unwrap_or(max);
+                if v > start {
+                    emit(start, v - 1, false);
+                }
+                emit(v, v, true);
+                next = (v < max).then(|| v + 1);
+            }
+            if let Some(start) = next {
+                emit(start, max, false);
+            }
+        } else {
+            // (position, +1 for a range start, -1 just past a range end)
+            let mut events: Vec<(i128, i32)> = Vec::new();
+            for pat in heads {
+                if let Ctor::Range(lo, hi) = pat.ctor {
+                    let (lo, hi) = (lo.max(min), hi.min(max));
+                    if lo > hi {
+                        continue;
+                    }
+                    events.push((lo, 1));
+                    if hi < max {
+                        events.push((hi + 1, -1));
+                    }
+                }
+            }
+            events.sort_unstable();
+
+            let mut start = min;
+            let mut depth = 0;
+            for (pos, delta) in events {
+                if pos > start {
+                    emit(start, pos - 1, depth > 0);
+                    start = pos;
+                }
+                depth += delta;
             }
+            emit(start, max, depth > 0);
         }
-        true
-    } else {
-        // No closed-type columns: fall back to checking if any row is all-wildcards
-        // (which we already checked above and it returned false)
-        false
-    }
-}
 
-/// Specialize a pattern matrix on column `col` for constructor `ctor`.
-///
-/// For each row in the matrix:
-/// - If `row[col]` matches `ctor` → include the row without column `col`
-/// - If `row[col]` is a wildcard → include the row without column `col`
-///   (wildcard matches any constructor)
-/// - Otherwise → row doesn't match, exclude it
-fn specialize_matrix(
-    matrix: &[Vec<Pattern>],
-    col: usize,
-    ctor: &ConstructorTag,
-) -> Vec<Vec<Pattern>> {
-    let mut result = Vec::new();
-
-    for row in matrix {
-        if col >= row.len() {
-            continue;
-        }
-
-        let matches = pattern_matches_constructor(&row[col], ctor);
-
-        if matches {
-            // Build new row without column `col`
-            let new_row: Vec<Pattern> = row
-                .iter()
-                .enumerate()
-                .filter(|(i, _)| *i != col)
-                .map(|(_, p)| p.clone())
-                .collect();
-            result.push(new_row);
+        // Without a known width the values outside every range cannot be
+        // enumerated; a wildcard stands for them.
+        if domain.is_none() {
+            split.missing.push(Ctor::Wild);
         }
     }
 
-    result
-}
-
-/// Check if a pattern matches a specific constructor.
-fn pattern_matches_constructor(pat: &Pattern, ctor: &ConstructorTag) -> bool {
-    match &pat.kind {
-        // Wildcards and bindings match any constructor
-        PatternKind::Wildcard => true,
-        PatternKind::Binding {
-            subpattern: None, ..
-        } => true,
-        PatternKind::Binding {
-            subpattern: Some(sub),
-            ..
-        } => pattern_matches_constructor(sub, ctor),
-
-        // Bool literals match their respective constructor
-        PatternKind::Literal(hir::LiteralValue::Bool(true)) => *ctor == ConstructorTag::BoolTrue,
-        PatternKind::Literal(hir::LiteralValue::Bool(false)) => *ctor == ConstructorTag::BoolFalse,
-
-        // Or patterns: matches if any alternative matches
-        PatternKind::Or(alts) => alts
-            .iter()
-            .any(|alt| pattern_matches_constructor(alt, ctor)),
-
-        // All other patterns don't match bool constructors
-        _ => false,
-    }
-}
-
-/// Fallback per-position check for tuples with all open types.
-fn check_tuple_per_position(
-    matrix: &[Vec<Pattern>],
-    element_types: &[Type],
-) -> (bool, Vec<String>) {
-    for (i, elem_ty) in element_types.iter().enumerate() {
-        let position_patterns: Vec<&Pattern> = matrix.iter().filter_map(|row| row.get(i)).collect();
-
-        let (is_exhaustive, missing) = is_exhaustive(&position_patterns, elem_ty, None);
-        if !is_exhaustive {
-            return (
-                false,
-                vec![format!("missing pattern at position {}: {:?}", i, missing)],
-            );
+    /// Appends row `i` of `matrix`, specialized to `ctor` with `arity`
+    /// fields, to `out`. The row's first pattern must match `ctor`; the row
+    /// stays relevant only if it was and `relevant` holds.
+    fn specialize_into(
+        &self,
+        out: &mut Matrix,
+        matrix: &Matrix,
+        i: usize,
+        ctor: Ctor,
+        arity: usize,
+        relevant: bool,
+    ) {
+        let row = matrix.row(i);
+        let head = &self.pats[row[0] as usize];
+        let start = out.cells.len();
+        out.cells.resize(start + arity, WILD);
+        for &(pos, pat) in self.pat_fields(head) {
+            // Suffix elements of a `..` slice line up with the end.
+            let pos = match (head.ctor, ctor) {
+                (Ctor::VarLen(prefix, suffix), _) if pos >= prefix => {
+                    arity as u32 - suffix + (pos - prefix)
+                }
+                _ => pos,
+            };
+            if (pos as usize) < arity {
+                out.cells[start + pos as usize] = pat;
+            }
         }
+        out.cells.extend_from_slice(&row[1..]);
+        let mut info = matrix.rows[i];
+        info.relevant &= relevant;
+        out.rows.push(info);
     }
 
-    (true, vec![])
-}
-
-/// Check array exhaustiveness.
-///
-/// ## Algorithm
-///
-/// For fixed-size arrays `[T; N]`, check if slice patterns cover all elements:
-///
-/// 1. **Quick check**: If any pattern is irrefutable (wildcard, binding), array is covered
-/// 2. **Slice pattern extraction**: Extract patterns of form `[prefix.., rest, ..suffix]`
-/// 3. **Length check**: A slice pattern matches if `prefix.len() + suffix.len() <= N`
-///    - With rest (`..`): Can absorb N - prefix.len() - suffix.len() elements
-///    - Without rest: Must match exactly if total length equals N
-/// 4. **Element coverage**: If pattern can match, check that all element patterns are irrefutable
-///
-/// ## Example
-///
-/// For `[i32; 3]` with pattern `[a, .., b]`:
-/// - prefix.len() = 1 (`a`)
-/// - suffix.len() = 1 (`b`)
-/// - rest absorbs 3 - 1 - 1 = 1 element
-/// - Pattern covers array if `a` and `b` are irrefutable
-///
-/// ## Limitation
-///
-/// Like tuple checking, this is simplified. Doesn't handle patterns like
-/// `[[1, ..], [.., 2]]` which together might cover all length-2 arrays.
-fn check_array_exhaustiveness(
-    patterns: &[&Pattern],
-    element_type: &Type,
-    size: u64,
-) -> (bool, Vec<String>) {
-    // For arrays, we check if the patterns cover all elements
-    // An array pattern [a, b, c] matching [T; 3] is exhaustive if all element
-    // patterns are irrefutable (wildcards or bindings)
-
-    // First check for wildcard/binding that covers the whole array
-    for pat in patterns {
-        if is_irrefutable(pat) {
-            return (true, vec![]);
-        }
-    }
-
-    // Extract slice patterns that could match this array
-    let slice_patterns: Vec<_> = patterns
-        .iter()
-        .filter_map(|p| {
-            if let PatternKind::Slice {
-                prefix,
-                slice,
-                suffix,
-            } = &p.kind
-            {
-                Some((prefix.as_slice(), slice.as_ref(), suffix.as_slice()))
-            } else {
-                None
-            }
-        })
-        .collect();
-
-    if slice_patterns.is_empty() {
-        // No slice patterns at all - not exhaustive unless there's a wildcard (checked above)
-        return (false, vec!["[_, _, ...]".to_string()]);
-    }
-
-    // For each slice pattern, check if it can cover the entire array
-    for (prefix, slice, suffix) in &slice_patterns {
-        // Pattern [p0, p1, .., sN-1, sN] matching [T; N]
-        let pattern_min_len = prefix.len() + suffix.len();
-
-        // Check if this pattern can match an array of size `size`
-        if slice.is_some() {
-            // Has a rest pattern (..) - can match any array with at least pattern_min_len elements
-            if pattern_min_len <= size as usize {
-                // Check if all subpatterns are irrefutable
-                let all_irrefutable = prefix.iter().all(is_irrefutable)
-                    && slice.as_ref().map_or(true, |p| is_irrefutable(p))
-                    && suffix.iter().all(is_irrefutable);
-                if all_irrefutable {
-                    return (true, vec![]);
+    /// A witness value built from `ctor` and witnesses for its fields.
+    fn witness(&mut self, ctor: Ctor, fields: Vec<Witness>, ty: Option<&Type>) -> Witness {
+        let list = |fields: &[Witness]| {
+            fields
+                .iter()
+                .map(|w| w.to_string())
+                .collect::<Vec<_>>()
+                .join(", ")
+        };
+        match ctor {
+            Ctor::Wild | Ctor::Or | Ctor::Opaque(_) => Witness::Wild,
+            Ctor::Bool(b) => Witness::Literal(b.to_string()),
+            Ctor::Range(lo, hi) => {
+                let is_char = matches!(
+                    ty.map(Type::kind),
+                    Some(TypeKind::Primitive(PrimitiveTy::Char))
+                );
+                let show = |v: i128| match u32::try_from(v).ok().and_then(char::from_u32) {
+                    Some(c) if is_char => format!("{c:?}"),
+                    _ => v.to_string(),
+                };
+                if lo == hi {
+                    Witness::Literal(show(lo))
+                } else {
+                    Witness::Literal(format!("{}..={}", show(lo), show(hi)))
                 }
             }
-        } else {
-            // No rest pattern - must match exact size
-            if pattern_min_len == size as usize {
-                // Check if all element patterns are irrefutable
-                let all_irrefutable = prefix.iter().all(is_irrefutable);
-                if all_irrefutable {
-                    return (true, vec![]);
+            Ctor::Variant(idx) => {
+                let name = ty
+                    .and_then(|ty| self.variant_info(ty))
+                    .and_then(|info| info.variant_names.get(idx as usize).cloned())
+                    .unwrap_or_else(|| format!("variant {}", idx));
+                Witness::Constructor { name, fields }
+            }
+            Ctor::Single => match ty.map(Type::kind) {
+                Some(TypeKind::Adt { .. }) if fields.iter().all(|w| matches!(w, Witness::Wild)) => {
+                    Witness::Wild
                 }
+                Some(TypeKind::Adt { .. }) => Witness::Literal(format!("{{ {} }}", list(&fields))),
+                _ => Witness::Constructor {
+                    name: String::new(),
+                    fields,
+                },
+            },
+            Ctor::FixedLen(_) => Witness::Literal(format!("[{}]", list(&fields))),
+            Ctor::VarLen(prefix, _) => {
+                let (head, tail) = fields.split_at(prefix as usize);
+                let parts: Vec<String> = [list(head), "..".to_string(), list(tail)]
+                    .into_iter()
+                    .filter(|part| !part.is_empty())
+                    .collect();
+                Witness::Literal(format!("[{}]", parts.join(", ")))
             }
         }
     }
+}
 
-    // Check element-wise exhaustiveness for patterns that match the exact size
-    for (prefix, slice, _suffix) in &slice_patterns {
-        if slice.is_none() && prefix.len() == size as usize {
-            // This pattern has exact size match - check each position
-            let mut all_positions_exhaustive = true;
-            for pat in prefix.iter() {
-                let (is_exhaustive, _) = is_exhaustive(&[pat], element_type, None);
-                if !is_exhaustive {
-                    all_positions_exhaustive = false;
-                    break;
-                }
-            }
-            if all_positions_exhaustive {
-                return (true, vec![]);
+/// The slice lengths a column must consider: each length up to the longest
+/// fixed-length pattern (or prefix + suffix) separately, then every longer
+/// slice at once.
+fn slice_ctors(heads: &[DeconPat<'_>], ty: Option<&Type>) -> Vec<Ctor> {
+    if let Some(TypeKind::Array { size, .. }) = ty.map(Type::kind) {
+        if let Some(len) = size.as_u64() {
+            return vec![Ctor::FixedLen(len as u32)];
+        }
+    }
+    let mut max_fixed: Option<u32> = None;
+    let mut var_len: Option<(u32, u32)> = None;
+    for pat in heads {
+        match pat.ctor {
+            Ctor::FixedLen(len) => max_fixed = Some(max_fixed.map_or(len, |m| m.max(len))),
+            Ctor::VarLen(prefix, suffix) => {
+                let (p, s) = var_len.unwrap_or((0, 0));
+                var_len = Some((p.max(prefix), s.max(suffix)));
             }
+            _ => {}
         }
     }
+    let (prefix, suffix) = match var_len {
+        None => (max_fixed.map_or(0, |m| m + 1), 0),
+        Some((prefix, suffix)) => match max_fixed {
+            // Lengths up to the longest fixed pattern are checked one by
+            // one; grow the prefix so the open-ended case starts after it.
+            Some(m) if m + 1 >= prefix + suffix => (m + 1 - suffix, suffix),
+            _ => (prefix, suffix),
+        },
+    };
+    let mut ctors: Vec<Ctor> = (0..prefix + suffix).map(Ctor::FixedLen).collect();
+    ctors.push(Ctor::VarLen(prefix, suffix));
+    ctors
+}
 
-    // Not exhaustive - suggest a wildcard pattern
-    (false, vec!["_".to_string()])
+/// The integer value of a literal, if it has one. `u128` values above
+/// `i128::MAX` are clamped; the domain of `u128` is clamped the same way.
+fn literal_int(lit: &LiteralValue) -> Option<i128> {
+    match lit {
+        LiteralValue::Int(v) => Some(*v),
+        LiteralValue::Uint(v) => Some(i128::try_from(*v).unwrap_or(i128::MAX)),
+        LiteralValue::Char(c) => Some(*c as i128),
+        _ => None,
+    }
 }
 
-/// Find unreachable arms (arms that can never match).
-fn find_unreachable_arms(patterns: &[&Pattern]) -> Vec<usize> {
-    let mut unreachable = vec![];
+/// The inclusive range of values of an integer or char type.
+fn int_domain(ty: &Type) -> Option<(i128, i128)> {
+    let TypeKind::Primitive(prim) = ty.kind() else {
+        return None;
+    };
+    Some(match prim {
+        PrimitiveTy::Int(IntTy::I8) => (i8::MIN as i128, i8::MAX as i128),
+        PrimitiveTy::Int(IntTy::I16) => (i16::MIN as i128, i16::MAX as i128),
+        PrimitiveTy::Int(IntTy::I32) => (i32::MIN as i128, i32::MAX as i128),
+        PrimitiveTy::Int(IntTy::I64 | IntTy::Isize) => (i64::MIN as i128, i64::MAX as i128),
+        PrimitiveTy::Int(IntTy::I128) => (i128::MIN, i128::MAX),
+        PrimitiveTy::Uint(UintTy::U8) => (0, u8::MAX as i128),
+        PrimitiveTy::Uint(UintTy::U16) => (0, u16::MAX as i128),
+        PrimitiveTy::Uint(UintTy::U32) => (0, u32::MAX as i128),
+        PrimitiveTy::Uint(UintTy::U64 | UintTy::Usize) => (0, u64::MAX as i128),
+        PrimitiveTy::Uint(UintTy::U128) => (0, i128::MAX),
+        PrimitiveTy::Char => (0, char::MAX as i128),
+        _ => return None,
+    })
+}
 
-    // Simple check: if we see a wildcard/binding pattern, all subsequent patterns are unreachable
-    let mut seen_irrefutable = false;
+/// Values inside the domain of `ty` that no value of `ty` takes: the
+/// surrogate code points, for `char`.
+fn int_domain_hole(ty: &Type) -> Option<(i128, i128)> {
+    match ty.kind() {
+        TypeKind::Primitive(PrimitiveTy::Char) => Some((0xD800, 0xDFFF)),
+        _ => None,
+    }
+}
 
-    for (i, pat) in patterns.iter().enumerate() {
-        if seen_irrefutable {
-            unreachable.push(i);
-        } else if is_irrefutable(pat) {
-            seen_irrefutable = true;
+/// `ty` without references or ownership qualifiers.
+fn peel(mut ty: &Type) -> &Type {
+    loop {
+        match ty.kind() {
+            TypeKind::Ref { inner, .. } | TypeKind::Ownership { inner, .. } => ty = inner,
+            _ => return ty,
         }
     }
+}
 
-    unreachable
+/// The definition of an ADT type, looking through references.
+fn adt_def_id(ty: &Type) -> Option<DefId> {
+    match peel(ty).kind() {
+        TypeKind::Adt { def_id, .. } => Some(*def_id),
+        _ => None,
+    }
 }
 
 /// Witness for a non-exhaustive pattern match.
@@ -741,7 +1077,8 @@ fn find_unreachable_arms(patterns: &[&Pattern]) -> Vec<usize> {
 pub enum Witness {
     /// A wildcard (any value).
     Wild,
-    /// A specific constructor (enum variant, tuple, etc.).
+    /// A specific constructor (enum variant, tuple, etc.). Tuples have an
+    /// empty name.
     Constructor { name: String, fields: Vec<Witness> },
     /// A literal value.
     Literal(String),
@@ -752,7 +1089,7 @@ impl std::fmt::Display for Witness {
         match self {
             Witness::Wild => write!(f, "_"),
             Witness::Constructor { name, fields } => {
-                if fields.is_empty() {
+                if fields.is_empty() && !name.is_empty() {
                     write!(f, "{}", name)
                 } else {
                     write!(
@@ -775,7 +1112,7 @@ impl std::fmt::Display for Witness {
 #[cfg(test)]
 mod tests {
     use super::*;
-    use crate::hir::{self, LiteralValue, Pattern, PatternKind, Type};
+    use crate::hir::{self, DefId, LiteralValue, Pattern, PatternKind, Type};
     use crate::span::Span;
 
     fn dummy_span() -> Span {
@@ -812,6 +1149,96 @@ mod tests {
         }
     }
 
+    fn u8_ty() -> Type {
+        Type::u8()
+    }
+
+    fn int_pat(val: i128, ty: Type) -> Pattern {
+        Pattern {
+            kind: PatternKind::Literal(LiteralValue::Int(val)),
+            span: dummy_span(),
+            ty,
+        }
+    }
+
+    fn range_pat(lo: i128, hi: i128, ty: Type) -> Pattern {
+        Pattern {
+            kind: PatternKind::Range {
+                start: Some(Box::new(int_pat(lo, ty.clone()))),
+                end: Some(Box::new(int_pat(hi, ty.clone()))),
+                inclusive: true,
+            },
+            span: dummy_span(),
+            ty,
+        }
+    }
+
+    fn or_pat(alts: Vec<Pattern>) -> Pattern {
+        Pattern {
+            kind: PatternKind::Or(alts),
+            span: dummy_span(),
+            ty: Type::error(),
+        }
+    }
+
+    fn slice_pat(prefix: Vec<Pattern>, rest: bool, ty: Type) -> Pattern {
+        Pattern {
+            kind: PatternKind::Slice {
+                prefix,
+                slice: rest.then(|| Box::new(wildcard_pat())),
+                suffix: vec![],
+            },
+            span: dummy_span(),
+            ty,
+        }
+    }
+
+    /// `enum Opt { None, Some(T) }`, identified by `def`.
+    fn opt_ty(def: u32) -> Type {
+        Type::adt(DefId::new(def), vec![])
+    }
+
+    fn opt_info(_ty: &Type) -> Option<EnumVariantInfo> {
+        Some(EnumVariantInfo {
+            variant_count: 2,
+            variant_names: vec!["None".to_string(), "Some".to_string()],
+        })
+    }
+
+    fn none_pat(ty: Type) -> Pattern {
+        Pattern {
+            kind: PatternKind::Variant {
+                def_id: DefId::new(100),
+                variant_idx: 0,
+                fields: vec![],
+            },
+            span: dummy_span(),
+            ty,
+        }
+    }
+
+    fn some_pat(inner: Pattern, ty: Type) -> Pattern {
+        Pattern {
+            kind: PatternKind::Variant {
+                def_id: DefId::new(101),
+                variant_idx: 1,
+                fields: vec![inner],
+            },
+            span: dummy_span(),
+            ty,
+        }
+    }
+
+    fn guarded_arm(pat: Pattern) -> hir::MatchArm {
+        let mut arm = make_arm(pat);
+        arm.guard = Some(hir::Expr::new(
+            hir::ExprKind::Literal(LiteralValue::Bool(true)),
+            Type::bool(),
+            dummy_span(),
+        ));
+        arm
+    }
+
     fn make_arm(pat: Pattern) -> hir::MatchArm {
         hir::MatchArm {
             pattern: pat,
@@ -907,4 +1334,173 @@ mod tests {
             "any pattern + wildcard should be exhaustive"
         );
     }
+
+    #[test]
+    fn test_tuple_diagonal_witnesses() {
+        let arms = vec![
+            make_arm(tuple_pat(vec![bool_pat(true), bool_pat(true)])),
+            make_arm(tuple_pat(vec![bool_pat(false), bool_pat(false)])),
+        ];
+        let scrutinee_ty = Type::tuple(vec![bool_ty(), bool_ty()]);
+        let result = check_exhaustiveness(&arms, &scrutinee_ty, None);
+        assert_eq!(
+            result.missing_patterns,
+            vec!["(true, false)", "(false, true)"]
+        );
+    }
+
+    #[test]
+    fn test_nested_enum_fields_are_checked() {
+        // Some(Some(true)), Some(None), None on Opt<Opt<bool>>
+        let inner = opt_ty(2);
+        let outer = opt_ty(1);
+        let arms = vec![
+            make_arm(some_pat(
+                some_pat(bool_pat(true), inner.clone()),
+                outer.clone(),
+            )),
+            make_arm(some_pat(none_pat(inner.clone()), outer.clone())),
+            make_arm(none_pat(outer.clone())),
+        ];
+        let result = check_exhaustiveness_with(&arms, &outer, &opt_info);
+        assert!(!result.is_exhaustive);
+        assert_eq!(result.missing_patterns, vec!["Some(Some(false))"]);
+
+        let mut arms = arms;
+        arms.push(make_arm(some_pat(wildcard_pat(), outer.clone())));
+        let result = check_exhaustiveness_with(&arms, &outer, &opt_info);
+        assert!(result.is_exhaustive);
+        assert!(result.unreachable_arms.is_empty());
+    }
+
+    #[test]
+    fn test_missing_enum_variant_named() {
+        let outer = opt_ty(1);
+        let arms = vec![make_arm(some_pat(wildcard_pat(), outer.clone()))];
+        let result = check_exhaustiveness_with(&arms, &outer, &opt_info);
+        assert_eq!(result.missing_patterns, vec!["None"]);
+    }
+
+    #[test]
+    fn test_integer_ranges() {
+        let full = vec![
+            make_arm(range_pat(0, 127, u8_ty())),
+            make_arm(range_pat(128, 255, u8_ty())),
+        ];
+        assert!(check_exhaustiveness(&full, &u8_ty(), None).is_exhaustive);
+
+        let gap = vec![
+            make_arm(range_pat(0, 100, u8_ty())),
+            make_arm(int_pat(150, u8_ty())),
+            make_arm(range_pat(200, 255, u8_ty())),
+        ];
+        let result = check_exhaustiveness(&gap, &u8_ty(), None);
+        assert_eq!(result.missing_patterns, vec!["101..=149", "151..=199"]);
+
+        // i32 without a wildcard is never covered by literals
+        let result = check_exhaustiveness(&[make_arm(int_pat(0, i32_ty()))], &i32_ty(), None);
+        assert!(!result.is_exhaustive);
+    }
+
+    #[test]
+    fn test_char_ranges_skip_surrogates() {
+        let char_ty = || Type::char();
+        let full = vec![
+            make_arm(range_pat(0, 0xD7FF, char_ty())),
+            make_arm(range_pat(0xE000, char::MAX as i128, char_ty())),
+        ];
+        assert!(check_exhaustiveness(&full, &char_ty(), None).is_exhaustive);
+
+        let one = vec![make_arm(int_pat('a' as i128, char_ty()))];
+        let result = check_exhaustiveness(&one, &char_ty(), None);
+        assert_eq!(
+            result.missing_patterns,
+            vec![
+                "'\\0'..='`'",
+                "'b'..='\\u{d7ff}'",
+                "'\\u{e000}'..='\\u{10ffff}'"
+            ]
+        );
+    }
+
+    #[test]
+    fn test_dense_integer_literals() {
+        let all: Vec<_> = (0..=255).map(|v| make_arm(int_pat(v, u8_ty()))).collect();
+        let result = check_exhaustiveness(&all, &u8_ty(), None);
+        assert!(result.is_exhaustive);
+        assert!(result.unreachable_arms.is_empty());
+
+        let mut most: Vec<_> = (0..=255)
+            .filter(|&v| v != 7 && v != 255)
+            .map(|v| make_arm(int_pat(v, u8_ty())))
+            .collect();
+        most.push(make_arm(int_pat(3, u8_ty())));
+        let result = check_exhaustiveness(&most, &u8_ty(), None);
+        assert_eq!(result.missing_patterns, vec!["7", "255"]);
+        assert_eq!(result.unreachable_arms, vec![254]);
+    }
+
+    #[test]
+    fn test_unreachable_arms() {
+        let arms = vec![
+            make_arm(int_pat(1, i32_ty())),
+            make_arm(range_pat(0, 10, i32_ty())),
+            make_arm(int_pat(5, i32_ty())),
+            make_arm(wildcard_pat()),
+            make_arm(int_pat(20, i32_ty())),
+        ];
+        let result = check_exhaustiveness(&arms, &i32_ty(), None);
+        assert!(result.is_exhaustive);
+        assert_eq!(result.unreachable_arms, vec![2, 4]);
+    }
+
+    #[test]
+    fn test_guarded_arms_do_not_cover() {
+        // `_ if g` neither makes later arms unreachable nor covers the type
+        let arms = vec![guarded_arm(wildcard_pat()), make_arm(bool_pat(true))];
+        let result = check_exhaustiveness(&arms, &bool_ty(), None);
+        assert!(!result.is_exhaustive);
+        assert_eq!(result.missing_patterns, vec!["false"]);
+        assert!(result.unreachable_arms.is_empty());
+    }
+
+    #[test]
+    fn test_or_patterns() {
+        let arms = vec![
+            make_arm(or_pat(vec![bool_pat(true), bool_pat(false)])),
+            make_arm(bool_pat(true)),
+        ];
+        let result = check_exhaustiveness(&arms, &bool_ty(), None);
+        assert!(result.is_exhaustive);
+        assert_eq!(result.unreachable_arms, vec![1]);
+    }
+
+    #[test]
+    fn test_slice_lengths() {
+        let ty = Type::slice(bool_ty());
+        let arms = vec![
+            make_arm(slice_pat(vec![], false, ty.clone())),
+            make_arm(slice_pat(vec![wildcard_pat()], true, ty.clone())),
+        ];
+        assert!(check_exhaustiveness(&arms, &ty, None).is_exhaustive);
+
+        let arms = vec![
+            make_arm(slice_pat(vec![], false, ty.clone())),
+            make_arm(slice_pat(vec![bool_pat(true)], true, ty.clone())),
+        ];
+        let result = check_exhaustiveness(&arms, &ty, None);
+        assert_eq!(result.missing_patterns, vec!["[false, ..]"]);
+
+        // Fixed-size arrays only have one length
+        let array = Type::array(bool_ty(), 2);
+        let arms = vec![
+            make_arm(slice_pat(
+                vec![bool_pat(true), wildcard_pat()],
+                false,
+                array.clone(),
+            )),
+            make_arm(slice_pat(vec![bool_pat(false)], true, array.clone())),
+        ];
+        assert!(check_exhaustiveness(&arms, &array, None).is_exhaustive);
+    }
 }
@@ -448,7 +448,9 @@ do_relink_first_gen() {
     local start_ts rc=0
     start_ts=$(date +%s)
 
-    # Match the exact link command from src/selfhost/main.blood:524-539
+    # Mirrors build_link_command in src/selfhost/main.blood. -z muldefs is
+    # kept here: these objects may come from a seed whose missing-def stubs
+    # predate weak linkage and collide with the runtime archive.
     local bin_path="$BUILD_DIR/first_gen"
     local clang_args=("$CLANG")
     # shellcheck disable=SC2206  # intentional glob expansion for .o files
@@ -593,7 +595,9 @@ do_build_libmprompt() {
     step "Building libmprompt"
 
     # Unity build: main.c includes mprompt.c, gstack.c, util.c
-    "$CLANG" -c -O2 -fPIC \
+    # Frame pointers are kept so profilers can unwind from a gstack back
+    # through mp_resume into the resuming stack (see longjmp_amd64.S).
+    "$CLANG" -c -O2 -fPIC -fno-omit-frame-pointer \
         -I"$mp_dir/include" \
         -I"$mp_src" \
         "$mp_src/main.c" -o "$mp_build/mprompt.o"
@@ -620,6 +624,7 @@ do_build_blood_runtime() {
     [ -f "$rt_dir/lib.blood" ] || die "Blood runtime source not found at $rt_dir/lib.blood"
     [ -f "$rt_dir/rt_mprompt_shim.c" ] || die "rt_mprompt_shim.c not found at $rt_dir/rt_mprompt_shim.c"
     [ -f "$rt_dir/rt_hashmap.c" ] || die "rt_hashmap.c not found at $rt_dir/rt_hashmap.c"
+    [ -f "$rt_dir/rt_heapprof.c" ] || die "rt_heapprof.c not found at $rt_dir/rt_heapprof.c"
     command -v python3 >/dev/null || die "python3 required for IR post-processing"
     command -v "$LLC" >/dev/null || die "$LLC required for object compilation"
     command -v "$CLANG" >/dev/null || die "$CLANG required for C runtime pieces"
@@ -659,7 +664,7 @@ do_build_blood_runtime() {
     # noise lines. See commit history around 2026-04-11 session 7 for detail.
     local llc_out="$rt_build/lib_clean.llc.log"
     local llc_status=0
-    "$LLC" -filetype=obj -relocation-model=pic "$rt_build/lib_clean.ll" \
+    "$LLC" -filetype=obj -relocation-model=pic -frame-pointer=all "$rt_build/lib_clean.ll" \
         -o "$rt_build/lib.o" >"$llc_out" 2>&1 || llc_status=$?
     # Surface any noise lines llc emitted (filtered to hide known-benign warnings).
     # Ignore grep's exit code; `grep || true` is safe here because we only want
@@ -673,19 +678,24 @@ do_build_blood_runtime() {
     # packaging a stale archive on future failures.
     [ -f "$rt_build/lib.o" ] || die "$LLC did not produce $rt_build/lib.o"
 
-    step "Compiling C runtime pieces (rt_hashmap.c, rt_mprompt_shim.c)"
+    step "Compiling C runtime pieces (rt_hashmap.c, rt_mprompt_shim.c, rt_heapprof.c)"
     # rt_hashmap.c contains the HashMap type-erased runtime (hashmap_new/get/
     # insert/iter/...). Was historically baked into bootstrap/ manually, but
     # freshly-built runtime archives would miss these symbols and fail hashmap
     # golden tests. Now unconditionally compiled so the archive is complete.
-    "$CLANG" -c -O2 -fPIC \
+    "$CLANG" -c -O2 -fPIC -fno-omit-frame-pointer \
         "$rt_dir/rt_hashmap.c" \
         -o "$rt_build/rt_hashmap.o"
-    "$CLANG" -c -O2 -fPIC \
+    "$CLANG" -c -O2 -fPIC -fno-omit-frame-pointer \
         -I"$REPO_ROOT/vendor/libmprompt/include" \
         "$rt_dir/rt_mprompt_shim.c" \
         -o "$rt_build/rt_mprompt_shim.o"
-    ok "rt_hashmap.o + rt_mprompt_shim.o"
+    # rt_heapprof.c is the sampling heap profiler behind the allocation hooks
+    # in alloc.blood (BLOOD_HEAP_PROFILE=<path>).
+    "$CLANG" -c -O2 -fPIC -fno-omit-frame-pointer \
+        "$rt_dir/rt_heapprof.c" \
+        -o "$rt_build/rt_heapprof.o"
+    ok "rt_hashmap.o + rt_mprompt_shim.o + rt_heapprof.o"
 
     # Build the archive fresh. `ar rcs` on an existing archive APPENDS members,
     # which would leave stale object files in place when the inputs change. `rm`
@@ -695,6 +705,7 @@ do_build_blood_runtime() {
         "$rt_build/lib.o" \
         "$rt_build/rt_hashmap.o" \
         "$rt_build/rt_mprompt_shim.o" \
+        "$rt_build/rt_heapprof.o" \
         "$mp_build/mprompt.o" \
         "$mp_build/longjmp_amd64.o"
     ok "libblood_runtime_blood.a ($(stat -c%s "$rt_build/libblood_runtime_blood.a") bytes)"
@@ -1071,6 +1082,53 @@ EOF
     fi
 }
 
+do_test_reproducible() {
+    # Builds the self-hosted compiler with 1, 4 and 16 parallel codegen
+    # threads and checks that the IR and object file are byte-identical.
+    # Every build writes to the same paths so debug info and file names
+    # can't differ; only the -j value changes between runs.
+    local compiler="${1:-$BUILD_DIR/first_gen}"
+    [ -f "$compiler" ] || die "$compiler not found"
+
+    step "Reproducible build: self-compile with -j 1, 4, 16"
+
+    local tmpdir
+    tmpdir=$(mktemp -d)
+    local ref_ll="" ref_o="" rc=0 jobs
+
+    for jobs in 1 4 16; do
+        rm -rf "$tmpdir/out"
+        mkdir -p "$tmpdir/out"
+        if ! "$compiler" build main.blood --no-cache --emit obj -j "$jobs" \
+            --build-dir "$tmpdir/out" -o "$tmpdir/out/main.ll" \
+            >"$tmpdir/j$jobs.log" 2>&1; then
+            fail "-j $jobs: compile failed"
+            tail -20 "$tmpdir/j$jobs.log" | sed 's/^/      /'
+            rc=1
+            continue
+        fi
+        local ll_hash o_hash
+        ll_hash=$(sha256sum "$tmpdir/out/main.ll" | cut -d' ' -f1)
+        o_hash=$(sha256sum "$tmpdir/out/main.o" | cut -d' ' -f1)
+        printf "  -j %-2s  ll %s  o %s\n" "$jobs" "${ll_hash:0:16}" "${o_hash:0:16}"
+        if [ -z "$ref_ll" ]; then
+            ref_ll="$ll_hash"
+            ref_o="$o_hash"
+            cp "$tmpdir/out/main.ll" "$tmpdir/ref.ll"
+        elif [ "$ll_hash" != "$ref_ll" ] || [ "$o_hash" != "$ref_o" ]; then
+            fail "-j $jobs output differs from -j 1"
+            diff "$tmpdir/ref.ll" "$tmpdir/out/main.ll" | head -20 | sed 's/^/      /'
+            rc=1
+        fi
+    done
+
+    rm -rf "$tmpdir"
+    if [ "$rc" -eq 0 ]; then
+        ok "IR and object identical across -j 1, 4, 16"
+    fi
+    return "$rc"
+}
+
 do_test_blood() {
     local compiler="${1:-$BLOOD_RUST}"
     [ -f "$compiler" ] || die "$compiler not found"
@@ -1463,6 +1521,7 @@ Test:
   test golden [compiler]    Run golden suite (default: first_gen)
   test golden-blood [compiler]    Run golden suite linked against Blood runtime
   test pillar2 [compiler]         Run Pillar 2 (content-addressing) end-to-end demo via proving/p5_identity
+  test reproducible [compiler]    Self-compile with -j 1/4/16 and compare IR + object hashes
   test dispatch [bin1] [bin2]     Compare dispatch behavior (default: bootstrap vs first_gen)
   test blood [compiler]           Run tests/blood-test/ (default: bootstrap)
 
@@ -1585,8 +1644,11 @@ case "${1:-status}" in
             pillar2)
                 do_test_pillar2 "$(resolve_compiler "${3:-first_gen}")"
                 ;;
+            reproducible)
+                do_test_reproducible "$(resolve_compiler "${3:-first_gen}")"
+                ;;
             *)
-                die "Unknown test suite: $2. Expected: golden, dispatch, blood, golden-blood, pillar2"
+                die "Unknown test suite: $2. Expected: golden, dispatch, blood, golden-blood, pillar2, reproducible"
                 ;;
         esac
         ;;